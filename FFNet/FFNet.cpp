@@ -39,6 +39,7 @@
 #include "PatternList.h"
 #include "Collection.h"
 #include "Categories.h"
+#include "MelderThread.h"
 
 static void bookkeeping (FFNet me);
 
@@ -414,29 +415,264 @@ void FFNet_computeDerivative (FFNet me) {
 
 /******* end operation ******************************************************/
 
-integer FFNet_getWinningUnit (FFNet me, integer labeling) {
-	const integer k = my numberOfNodes - my numberOfOutputs;
+/******* batch operation ****************************************************/
+
+/*
+	The batch versions of steps 1 to 4 handle a block of patterns at a time.
+	The activities, derivatives and errors of all the nodes for all the patterns in a block
+	are kept in matrices with a row for each pattern and a column for each node (numbered as in my activity),
+	so that every layer can be computed with matrix multiplications:
+		activity [layer]  = f (activity [layer - 1] . W [layer]')
+		error [layer - 1] = (error [layer] . W [layer]) * f' (activity [layer - 1])
+		dw [layer]        = - error [layer]' . activity [layer - 1]
+	where W [layer] has a row for each unit and a column for each unit in the previous layer (plus its bias),
+	which is exactly how the weights are stored in my w.
+	The costs and derivatives are summed per stretch of blocks (see MelderThread_runInStretches),
+	and then over the stretches.
+*/
+
+struct FFNet_Layer {
+	integer numberOfUnits, firstNode, lastNode;   // the units in this layer
+	integer numberOfInputs, firstInputNode, lastInputNode;   // the units in the previous layer, plus its bias node
+	integer firstWeight;
+	constMAT weights (FFNet me) const {
+		return constMAT (& my w [firstWeight], numberOfUnits, numberOfInputs);
+	}
+};
+
+static FFNet_Layer FFNet_getLayer (FFNet me, integer layer) {
+	FFNet_Layer result;
+	result.numberOfUnits = my numberOfUnitsInLayer [layer];
+	result.firstNode = FFNet_getNodeNumberFromUnitNumber (me, 1, layer);
+	result.lastNode = result.firstNode + result.numberOfUnits - 1;
+	result.firstInputNode = my nodeFirst [result.firstNode];
+	result.lastInputNode = my nodeLast [result.firstNode];
+	result.numberOfInputs = result.lastInputNode - result.firstInputNode + 1;
+	result.firstWeight = my wFirst [result.firstNode];
+	return result;
+}
+
+constexpr integer FFNet_BATCH_BLOCK_SIZE = 256;
+constexpr integer FFNet_BATCH_MAXIMUM_NUMBER_OF_STRETCHES = 64;
+
+Thing_define (FFNet_BatchWorkspace, Thing) { public:
+	autoMAT activity, deriv, error;   // [1..FFNet_BATCH_BLOCK_SIZE] [1..numberOfNodes]
+	autoVEC dw;   // [1..numberOfWeights]
+};
+
+Thing_implement (FFNet_BatchWorkspace, Thing, 0);
+
+static autoFFNet_BatchWorkspace FFNet_BatchWorkspace_create (FFNet me, bool withError, bool withDerivative) {
+	autoFFNet_BatchWorkspace thee = Thing_new (FFNet_BatchWorkspace);
+	thy activity = zero_MAT (FFNet_BATCH_BLOCK_SIZE, my numberOfNodes);
+	thy deriv = zero_MAT (FFNet_BATCH_BLOCK_SIZE, my numberOfNodes);
+	for (integer inode = 1; inode <= my numberOfNodes; inode ++)
+		if (my isbias [inode])
+			thy activity.column (inode)  <<=  1.0;
+	if (withError)
+		thy error = zero_MAT (FFNet_BATCH_BLOCK_SIZE, my numberOfNodes);
+	if (withDerivative)
+		thy dw = zero_VEC (my numberOfWeights);
+	return thee;
+}
+
+/*
+	Step 1 for a block of patterns, up to and including `toLayer`.
+	`transposedWeights` contains W [layer]' at the positions of W [layer] in my w.
+*/
+static void FFNet_BatchWorkspace_propagate (FFNet_BatchWorkspace me, FFNet net, constVEC const& transposedWeights,
+	constMATVU const& input, integer toLayer)
+{
+	const integer numberOfPatterns = input.nrow;
+	const MATVU activity = my activity.horizontalBand (1, numberOfPatterns);
+	const MATVU deriv = my deriv.horizontalBand (1, numberOfPatterns);
+	activity.verticalBand (1, net -> numberOfInputs)  <<=  input;
+	for (integer ilayer = 1; ilayer <= toLayer; ilayer ++) {
+		const FFNet_Layer layer = FFNet_getLayer (net, ilayer);
+		const MATVU layerActivity = activity.verticalBand (layer.firstNode, layer.lastNode);
+		mul_fast_MAT_out (layerActivity, activity.verticalBand (layer.firstInputNode, layer.lastInputNode),
+				constMAT (& transposedWeights [layer.firstWeight], layer.numberOfInputs, layer.numberOfUnits));
+		const MATVU layerDeriv = deriv.verticalBand (layer.firstNode, layer.lastNode);
+		if (ilayer == net -> numberOfLayers && net -> outputsAreLinear) {
+			layerDeriv  <<=  1.0;
+		} else {
+			for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++)
+				for (integer iunit = 1; iunit <= layer.numberOfUnits; iunit ++)
+					layerActivity [ipattern] [iunit] = net -> nonLinearity (net,
+							layerActivity [ipattern] [iunit], & layerDeriv [ipattern] [iunit]);
+		}
+	}
+}
+
+/*
+	Steps 2 to 4 for a block of patterns, after step 1; returns the cost,
+	and puts the derivative in my dw, if the workspace was created with a derivative.
+*/
+static double FFNet_BatchWorkspace_computeErrorAndDerivative (FFNet_BatchWorkspace me, FFNet net, constMATVU const& target) {
+	const integer numberOfPatterns = target.nrow;
+	const MATVU activity = my activity.horizontalBand (1, numberOfPatterns);
+	const MATVU deriv = my deriv.horizontalBand (1, numberOfPatterns);
+	const MATVU error = my error.horizontalBand (1, numberOfPatterns);
+	/*
+		Compute the error at the output layer, as minimumSquaredError () and minimumCrossEntropy () do.
+	*/
+	const FFNet_Layer outputLayer = FFNet_getLayer (net, net -> numberOfLayers);
+	Melder_assert (target.ncol == outputLayer.numberOfUnits);
+	double cost = 0.0;
+	for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++) {
+		const constVECVU output = activity [ipattern].part (outputLayer.firstNode, outputLayer.lastNode);
+		const VECVU outputError = error [ipattern].part (outputLayer.firstNode, outputLayer.lastNode);
+		double patternCost = 0.0;
+		if (net -> costFunctionType == 2) {
+			for (integer i = 1; i <= outputLayer.numberOfUnits; i ++) {
+				const double t1 = 1.0 - target [ipattern] [i];
+				const double o1 = 1.0 - output [i];
+				patternCost -= target [ipattern] [i] * log (output [i]) + t1 * log (o1);
+				outputError [i] = -t1 / o1 + target [ipattern] [i] / output [i];
+			}
+		} else {
+			for (integer i = 1; i <= outputLayer.numberOfUnits; i ++) {
+				const double e = outputError [i] = target [ipattern] [i] - output [i];
+				patternCost += e * e;
+			}
+			patternCost *= 0.5;
+		}
+		cost += patternCost;
+	}
+	if (NUMisEmpty (my dw.get()))
+		return cost;
+	/*
+		Backpropagate the error from the output layer to the first hidden layer,
+		computing the derivatives of the weights on the way.
+	*/
+	for (integer ilayer = net -> numberOfLayers; ilayer >= 1; ilayer --) {
+		const FFNet_Layer layer = FFNet_getLayer (net, ilayer);
+		const MATVU layerError = error.verticalBand (layer.firstNode, layer.lastNode);
+		layerError  *=  deriv.verticalBand (layer.firstNode, layer.lastNode);
+		if (ilayer > 1)
+			mul_fast_MAT_out (error.verticalBand (layer.firstInputNode, layer.lastInputNode - 1),   // not the bias node
+					layerError, layer.weights (net).verticalBand (1, layer.numberOfInputs - 1));
+		const MAT layerDw (& my dw [layer.firstWeight], layer.numberOfUnits, layer.numberOfInputs);
+		mul_fast_MAT_out (layerDw, layerError.transpose (), activity.verticalBand (layer.firstInputNode, layer.lastInputNode));
+	}
+	return cost;
+}
+
+/*
+	Runs `analyseBlock` for the blocks of patterns (see MelderThread_runInStretches),
+	each thread with a workspace of its own.
+*/
+static void FFNet_runBatch (FFNet me, integer numberOfPatterns, bool withError, bool withDerivative,
+	std::function <void (FFNet_BatchWorkspace workspace, integer istretch, integer fromPattern, integer toPattern)> const& analyseBlock)
+{
+	const integer numberOfStretches = MelderThread_computeNumberOfStretches (numberOfPatterns,
+			FFNet_BATCH_BLOCK_SIZE, FFNet_BATCH_MAXIMUM_NUMBER_OF_STRETCHES);
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfStretches, 1);
+	OrderedOf <structFFNet_BatchWorkspace> workspaces;
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		workspaces. addItem_move (FFNet_BatchWorkspace_create (me, withError, withDerivative));
+	MelderThread_runInStretches (numberOfThreads, numberOfPatterns, FFNet_BATCH_BLOCK_SIZE, FFNet_BATCH_MAXIMUM_NUMBER_OF_STRETCHES,
+		[&] (integer ithread, integer istretch, integer fromPattern, integer toPattern) {
+			const FFNet_BatchWorkspace workspace = workspaces.at [ithread];
+			analyseBlock (workspace, istretch, fromPattern, toPattern);
+			if (toPattern == numberOfPatterns) {
+				/*
+					Leave the network in the state of the last pattern, as the pattern-by-pattern steps do.
+				*/
+				const integer lastRow = toPattern - fromPattern + 1;
+				my activity.all()  <<=  workspace -> activity.row (lastRow);
+				my deriv.all()  <<=  workspace -> deriv.row (lastRow);
+			}
+		}
+	);
+}
+
+static autoVEC FFNet_getTransposedWeights (FFNet me) {
+	autoVEC result = raw_VEC (my numberOfWeights);
+	for (integer ilayer = 1; ilayer <= my numberOfLayers; ilayer ++) {
+		const FFNet_Layer layer = FFNet_getLayer (me, ilayer);
+		MAT (& result [layer.firstWeight], layer.numberOfInputs, layer.numberOfUnits)  <<=  layer.weights (me).transpose ();
+	}
+	return result;
+}
+
+void FFNet_propagateToLayer_batch (FFNet me, constMATVU const& inputs, MATVU const& activities, integer layer) {
+	Melder_require (layer > 0 && layer <= my numberOfLayers,
+		U"Layer should be between 1 and ", my numberOfLayers, U".");
+	Melder_assert (inputs.ncol == my numberOfInputs);
+	Melder_assert (activities.nrow == inputs.nrow && activities.ncol == my numberOfUnitsInLayer [layer]);
+	if (inputs.nrow == 0)
+		return;
+	const autoVEC transposedWeights = FFNet_getTransposedWeights (me);
+	const FFNet_Layer toLayer = FFNet_getLayer (me, layer);
+	FFNet_runBatch (me, inputs.nrow, false, false,
+		[&] (FFNet_BatchWorkspace workspace, integer /* istretch */, integer fromPattern, integer toPattern) {
+			FFNet_BatchWorkspace_propagate (workspace, me, transposedWeights.get(), inputs.part (fromPattern, toPattern, 1, inputs.ncol), layer);
+			activities.part (fromPattern, toPattern, 1, activities.ncol)  <<=
+					workspace -> activity.part (1, toPattern - fromPattern + 1, toLayer.firstNode, toLayer.lastNode);
+		}
+	);
+	if (layer < my numberOfLayers)
+		FFNet_propagate (me, copy_VEC (inputs.row (inputs.nrow)).get(), nullptr);   // the complete state of the last pattern, as in FFNet_propagateToLayer ()
+}
+
+double FFNet_computeErrorAndDerivative_batch (FFNet me, constMATVU const& inputs, constMATVU const& targets, VEC const& dw) {
+	Melder_assert (inputs.ncol == my numberOfInputs);
+	Melder_assert (targets.nrow == inputs.nrow && targets.ncol == my numberOfOutputs);
+	Melder_assert (dw.size == 0 || dw.size == my numberOfWeights);
+	dw  <<=  0.0;
+	if (inputs.nrow == 0)
+		return 0.0;
+	const autoVEC transposedWeights = FFNet_getTransposedWeights (me);
+	const integer numberOfStretches = MelderThread_computeNumberOfStretches (inputs.nrow,
+			FFNet_BATCH_BLOCK_SIZE, FFNet_BATCH_MAXIMUM_NUMBER_OF_STRETCHES);
+	autoVEC stretchCost = zero_VEC (numberOfStretches);
+	autoMAT stretchDw = zero_MAT (numberOfStretches, dw.size);
+	FFNet_runBatch (me, inputs.nrow, true, dw.size > 0,
+		[&] (FFNet_BatchWorkspace workspace, integer istretch, integer fromPattern, integer toPattern) {
+			FFNet_BatchWorkspace_propagate (workspace, me, transposedWeights.get(), inputs.part (fromPattern, toPattern, 1, inputs.ncol), my numberOfLayers);
+			stretchCost [istretch] += FFNet_BatchWorkspace_computeErrorAndDerivative (workspace, me, targets.part (fromPattern, toPattern, 1, targets.ncol));
+			if (dw.size > 0)
+				stretchDw.row (istretch)  -=  workspace -> dw.get();
+		}
+	);
+	longdouble cost = 0.0;
+	for (integer istretch = 1; istretch <= numberOfStretches; istretch ++) {
+		cost += stretchCost [istretch];
+		if (dw.size > 0)
+			dw  +=  stretchDw.row (istretch);
+	}
+	return double (cost);
+}
+
+integer FFNet_getWinningUnitOfOutput (FFNet me, constVEC const& output, integer labeling) {
+	Melder_assert (output.size == my numberOfOutputs);
 	integer winningUnit = 1;
 	if (labeling == 2) { /* stochastic */
 		double sum = 0.0;
 		for (integer ioutput = 1; ioutput <= my numberOfOutputs; ioutput ++)
-			sum += my activity [k + ioutput];
+			sum += output [ioutput];
 
 		const double random = NUMrandomUniform (0.0, sum);
 		for (winningUnit = my numberOfOutputs; winningUnit >= 2; winningUnit--)
-			if (random > (sum -= my activity [k + winningUnit]))
+			if (random > (sum -= output [winningUnit]))
 				break;
 	} else { /* winner-takes-all */
-		double max = my activity [k + 1];
+		double max = output [1];
 		for (integer ioutput = 2; ioutput <= my numberOfOutputs; ioutput ++)
-			if (my activity [k + ioutput] > max) {
-				max = my activity [k + ioutput];
+			if (output [ioutput] > max) {
+				max = output [ioutput];
 				winningUnit = ioutput;
 			}
 	}
 	return winningUnit;
 }
 
+integer FFNet_getWinningUnit (FFNet me, integer labeling) {
+	const integer k = my numberOfNodes - my numberOfOutputs;
+	return FFNet_getWinningUnitOfOutput (me, my activity.part (k + 1, k + my numberOfOutputs), labeling);
+}
+
 void FFNet_propagateToLayer (FFNet me, constVEC input, VEC activity, integer layer) {
 	Melder_require (layer > 0,
 		U"Layer must be greater than zero.");
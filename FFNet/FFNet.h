@@ -178,6 +178,20 @@ integer FFNet_getWinningUnit (FFNet me, integer labeling);
 /* labeling = 1 : winner-takes-all */
 /* labeling = 2 : stochastic */
 
+integer FFNet_getWinningUnitOfOutput (FFNet me, constVEC const& output, integer labeling);
+/* the same, for an output activity that was computed with FFNet_propagateToLayer_batch */
+
+/*
+	Batch versions of the steps above, for many patterns at a time (one pattern per row),
+	computed layer by layer with matrix multiplications, and distributed over threads.
+	Afterwards, the network is in the state of the last pattern.
+*/
+void FFNet_propagateToLayer_batch (FFNet me, constMATVU const& inputs, MATVU const& activities, integer layer);
+/* steps (1) for all inputs; activities [ipattern] := the activities of the units in layer */
+
+double FFNet_computeErrorAndDerivative_batch (FFNet me, constMATVU const& inputs, constMATVU const& targets, VEC const& dw);
+/* steps (1) to (4) for all inputs; returns the total cost, and puts the sum of the derivatives in dw (if not empty) */
+
 void FFNet_selectAllWeights (FFNet me);
 
 void FFNet_selectBiasesInLayer (FFNet me, integer layer);
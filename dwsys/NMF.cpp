@@ -280,13 +280,13 @@ void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximu
 			// 1. Update W matrix
 			features0.all()  <<=  my features.all();
 			weights0.all()  <<=  my weights.all();
-			mul_MAT_out (productFtD.get(), features0.transpose(), data);
+			mul_fast_MAT_out (productFtD.get(), features0.transpose(), data);
 			mul_MAT_out (productFtF.get(), features0.transpose(), features0.get());
 			mul_MAT_out (productFtFW.get(), productFtF.get(), weights0.get());
 			update (my weights.get(), weights0.get(), productFtD.get(), productFtFW.get(), eps, maximum);
 
 			// 2. Update F matrix
-			mul_MAT_out (productDWt.get(), data, my weights.transpose()); // productDWt = data*weights'
+			mul_fast_MAT_out (productDWt.get(), data, my weights.transpose()); // productDWt = data*weights'
 			mul_MAT_out (productWWt.get(), my weights.get(), my weights.transpose()); // work1 = weights*weights'
 			mul_MAT_out (productFWWt.get(), features0.get(), productWWt.get()); // productFWWt = features0 * work1
 			update (my features.get(), features0.get(), productDWt.get(), productFWWt.get(), eps, maximum);
@@ -362,7 +362,7 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 				1. Solve equations for new W:  F´*F*W = F'*D
 			*/
 			weights0.all()  <<=  my weights.all();   // save previous weights for convergence test
-			mul_MAT_out (productFtD.get(), my features.transpose(), data);
+			mul_fast_MAT_out (productFtD.get(), my features.transpose(), data);
 			mul_MAT_out (productFtF.get(), my features.transpose(), my features.get());
 
 			svd_FtF -> u.all()  <<=  productFtF.all();
@@ -374,7 +374,7 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 				2. Solve equations for new F:  W*W'*F' = W*D'
 			*/
 			features0.all()  <<=  my features.all();   // save previous features for convergence test
-			mul_MAT_out  (productWDt.get(), my weights.get(), data.transpose());
+			mul_fast_MAT_out (productWDt.get(), my weights.get(), data.transpose());
 			mul_MAT_out (productWWt.get(), my weights.get(), my weights.transpose());
 
 			svd_WWt -> u.all()  <<=  productWWt.all();
@@ -23,6 +23,7 @@
 */
 
 #include <algorithm>
+#include <memory>
 #include <limits.h>
 #include "melder.h"
 #include "MAT_numerics.h"
@@ -882,11 +883,36 @@ double NUMminimize_brent (double (*f) (double x, void *closure), double a, doubl
 
 /********************** fft ******************************************/
 
+/*
+	The factorization of n and the twiddle factors for an FFT of size n.
+	A plan never changes after it has been made, so that it can be shared between threads.
+*/
+struct structNUMfft_Plan
+{
+	integer n;
+	autoVEC twiddles;   // 2 * n
+	autoINTVEC factors;   // 32
+};
+
+void NUMfft_Plan_init (structNUMfft_Plan *plan, integer n);
+/*
+	Computes a plan without looking in the cache.
+*/
+
+std::shared_ptr <structNUMfft_Plan> NUMfft_getPlan (integer n);
+/*
+	Plans are kept in a process-wide cache, keyed by size,
+	so that analyses that transform thousands of frames (or sounds) of the same size
+	compute the twiddle factors only once; this function is thread-safe.
+	Only powers of two up to 2^20 and sizes up to 1024 are cached, so that the cache
+	can never hold more than some 40 MB; plans for all other sizes are computed on every call.
+*/
+
 struct structNUMfft_Table
 {
-  integer n;
-  autoVEC trigcache;
-  autoINTVEC splitcache;
+	integer n;
+	std::shared_ptr <structNUMfft_Plan> plan;
+	autoVEC work;   // scratch space for a single transform, so that a table cannot be used by two threads at the same time
 };
 
 typedef struct structNUMfft_Table *NUMfft_Table;
@@ -894,6 +920,7 @@ typedef struct structNUMfft_Table *NUMfft_Table;
 void NUMfft_Table_init (NUMfft_Table table, integer n);
 /*
 	n : data size
+	Cheap if a table of size n has been initialized before, because the plan comes from the cache.
 */
 
 struct autoNUMfft_Table : public structNUMfft_Table {
@@ -977,6 +1004,13 @@ void NUMfft_backward (NUMfft_Table table, VEC data);
 	sequence by n.
 */
 
+void NUMfft_forward (NUMfft_Table table, MAT frames);
+void NUMfft_backward (NUMfft_Table table, MAT frames);
+/*
+	Batched versions: transform every row of `frames` (numberOfFrames x n, so that every frame is contiguous)
+	in the same way as NUMfft_forward (table, frames.row (iframe)) or NUMfft_backward (table, frames.row (iframe)).
+*/
+
 /**** Compatibility with NR fft's */
 
 void NUMforwardRealFastFourierTransform (VEC data);
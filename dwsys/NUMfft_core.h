@@ -106,13 +106,6 @@ static void drfti1 (integer n, FFT_DATA_TYPE * wa, integer *ifac)
 	}
 }
 
-static void NUMrffti (integer n, FFT_DATA_TYPE * wsave, integer *ifac)
-{
-	if (n == 1)
-		return;
-	drfti1 (n, wsave + n, ifac);
-}
-
 /* void NUMcosqi(integer n, FFT_DATA_TYPE *wsave, integer *ifac){ static
    double pih = 1.57079632679489661923132169163975; static integer k;
    static double fk, dt;
@@ -23,6 +23,8 @@
 
 #include "NUM2.h"
 #include "melder.h"
+#include <mutex>
+#include <unordered_map>
 
 #define FFT_DATA_TYPE double
 #include "NUMfft_core.h"
@@ -57,14 +59,58 @@ void NUMreverseRealFastFourierTransform (VEC data) {
 	NUMfft_backward (& table, data);
 }
 
+void NUMfft_Plan_init (structNUMfft_Plan *me, integer n) {
+	my n = n;
+	my twiddles = zero_VEC (2 * n);
+	my factors = zero_INTVEC (32);
+	if (n > 1)
+		drfti1 (n, my twiddles.asArgumentToFunctionThatExpectsZeroBasedArray(),
+			my factors.asArgumentToFunctionThatExpectsZeroBasedArray()
+		);
+}
+
+std::shared_ptr <structNUMfft_Plan> NUMfft_getPlan (integer n) {
+	Melder_assert (n >= 1);
+	/*
+		The cache never evicts a plan, so it has to be limited to a fixed set of sizes:
+		the powers of two up to 2^20 (together 32 MB of twiddle factors),
+		which is what the analyses use, and the small sizes (together 8 MB at most).
+	*/
+	constexpr integer maximumCachedPowerOfTwo = 1 << 20;
+	constexpr integer maximumCachedSmallSize = 1024;
+	const bool isPowerOfTwo = ( (n & (n - 1)) == 0 );
+	const bool isCached = ( n <= maximumCachedSmallSize || (isPowerOfTwo && n <= maximumCachedPowerOfTwo) );
+	if (! isCached) {
+		auto plan = std::make_shared <structNUMfft_Plan> ();
+		NUMfft_Plan_init (plan.get(), n);
+		return plan;
+	}
+	static std::mutex cacheMutex;
+	static std::unordered_map <integer, std::shared_ptr <structNUMfft_Plan>> cache;
+	std::lock_guard <std::mutex> lock (cacheMutex);
+	std::shared_ptr <structNUMfft_Plan>& plan = cache [n];
+	if (! plan) {
+		auto newPlan = std::make_shared <structNUMfft_Plan> ();
+		NUMfft_Plan_init (newPlan.get(), n);
+		plan = std::move (newPlan);   // only after success, so that an exception leaves no empty plan in the cache
+	}
+	return plan;
+}
+
+void NUMfft_Table_init (NUMfft_Table me, integer n) {
+	my plan = NUMfft_getPlan (n);
+	my work = raw_VEC (n);
+	my n = n;
+}
+
 void NUMfft_forward (NUMfft_Table me, VEC data) {
 	if (my n == 1)
 		return;
 	Melder_assert (my n == data.size);
 	drftf1 (my n, data.asArgumentToFunctionThatExpectsZeroBasedArray(),
-		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
-		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray() + my n,
-		my splitcache.asArgumentToFunctionThatExpectsZeroBasedArray()
+		my work.asArgumentToFunctionThatExpectsZeroBasedArray(),
+		my plan -> twiddles.asArgumentToFunctionThatExpectsZeroBasedArray(),
+		my plan -> factors.asArgumentToFunctionThatExpectsZeroBasedArray()
 	);
 }
 
@@ -73,19 +119,22 @@ void NUMfft_backward (NUMfft_Table me, VEC data) {
 		return;
 	Melder_assert (my n == data.size);
 	drftb1 (my n, data.asArgumentToFunctionThatExpectsZeroBasedArray(),
-		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
-		my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray() + my n,
-		my splitcache.asArgumentToFunctionThatExpectsZeroBasedArray()
+		my work.asArgumentToFunctionThatExpectsZeroBasedArray(),
+		my plan -> twiddles.asArgumentToFunctionThatExpectsZeroBasedArray(),
+		my plan -> factors.asArgumentToFunctionThatExpectsZeroBasedArray()
 	);
 }
 
-void NUMfft_Table_init (NUMfft_Table me, integer n) {
-	my n = n;
-	my trigcache = zero_VEC (3 * n);
-	my splitcache = zero_INTVEC (32);
-	NUMrffti (n, my trigcache.asArgumentToFunctionThatExpectsZeroBasedArray(),
-		my splitcache.asArgumentToFunctionThatExpectsZeroBasedArray()
-	);
+void NUMfft_forward (NUMfft_Table me, MAT frames) {
+	Melder_assert (my n == frames.ncol);
+	for (integer iframe = 1; iframe <= frames.nrow; iframe ++)
+		NUMfft_forward (me, frames.row (iframe));
+}
+
+void NUMfft_backward (NUMfft_Table me, MAT frames) {
+	Melder_assert (my n == frames.ncol);
+	for (integer iframe = 1; iframe <= frames.nrow; iframe ++)
+		NUMfft_backward (me, frames.row (iframe));
 }
 
 void NUMrealft (VEC data, integer isign) {
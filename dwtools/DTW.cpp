@@ -174,119 +174,122 @@ void DTW_Path_Query_init (DTW_Path_Query me, integer ny, integer nx) {
 }
 
 /* Recode the path from a chain of cells to a piecewise linear path. */
-void DTW_Path_recode (DTW me) {
-	try {
-		DTW_Path_Query thee = & my pathQuery;
-		integer nxy;		// current number of elements in recoded path
-		integer nsc_x = 1;	// current number of successive horizontal cells in the cells chain
-		integer nsc_y = 1;	// current number of successive vertical cells in the cells chain
-		integer nd = 0;	// current number of successive diagonal cells in the cells chain
-		bool yDirection = false;	// previous segment in the original path was vertical
-		bool xDirection = false;	// previous segment in the original path was horizontal
-		integer ixp = 0, iyp = 0; // previous cell
-		struct structPoint {
-			double x,y;
-		};
-
-		// 1. Starting point always at origin
-		
-		const integer nxymax = thy nx + thy ny + 2;
-		autovector <structPoint> xytimes = newvectorzero <structPoint> (nxymax);
-		xytimes [1]. x = my xmin;
-		xytimes [1]. y = my ymin;
-		
-		// 2. next point lower left of first cell
-		
-		nsc_x = my path [1]. x;
-		ixp = nsc_x - 1;
-		xytimes [2]. x = my x1 + (nsc_x - 1 - 0.5) * my dx;
-		nsc_y = my path [1]. y;
-		iyp = nsc_y - 1;
-		xytimes [2]. y = my y1 + (nsc_y - 1 - 0.5) * my dy;
-		
-		// 3. follow all cells. implicit: my x1 - 0.5 * my dx > my xmin && my y1 - 0.5 * my dy > my ymin */
-		
-		nxy = 2;
-		for (integer j = 1; j <= my pathLength; j ++) {
-			const integer ix = my path [j]. x, iy = my path [j]. y;
-			const double xright = my x1 + (ix - 1 + 0.5) * my dx;
-			const double ytop = my y1 + (iy - 1 + 0.5) * my dy;
-			double x, y, f;
-			integer index; // where are we in the new path?
-
-			if (iy == iyp) { // horizontal path?
-				xDirection = true;
-				if (yDirection) {
-					// We came from a vertical direction so this is the second horizontal cell in a row.
-					// The statement after this "if" updates nsc_x to 2.
-					nsc_x = 1;
-					yDirection = false;
-				}
-				nsc_x ++;
-
-				if (nsc_y > 1 || nd > 1) {
-					// Previous segment was diagonal or vertical: modify intersection
-					// The vh intersection (x,y) = (nsc_x*dx, dy) * (nsc_y-1)/(nsc_x*nsc_y-1)
-					// A diagonal segment has nsc_y = 1.
-					f = (nsc_y - 1.0) / (nsc_x * nsc_y - 1);
-					x = xright - nsc_x * my dx + nsc_x * my dx * f;
-					y = ytop - my dy + my dy * f;
-					index = nxy - 1;
-					if (nsc_x == 2)
-						index = nxy ++;
-
-					xytimes [index]. x = x;
-					xytimes [index]. y = y;
-				}
-				nd = 0;
-			} else if (ix == ixp) { // vertical
-				yDirection = true;
-				if (xDirection) {
-					nsc_y = 1;
-					xDirection = false;
-				}
-				nsc_y ++;
-
-				if (nsc_x > 1 || nd > 1) {
-					// The hv intersection (x,y) = (dx, dy*nsc_y ) * (nsc_x-1)/(nsc_x*nsc_y-1)
-					f = (nsc_x - 1.0) / (nsc_x * nsc_y - 1);
-					x = xright - my dx + my dx * f;
-					y = ytop - nsc_y * my dy + nsc_y * my dy * f;
-					index = nxy - 1;
-					if (nsc_y == 2)
-						index = nxy ++;
-					xytimes [index]. x = x;
-					xytimes [index]. y = y;
-				}
-				nd = 0;
-			} else if (ix == ixp + 1 && iy == iyp + 1) {   // diagonal
-				nd ++;
-				if (nd == 1)
-					nxy ++;
-				nsc_x = nsc_y = 1;
-			} else {
-				Melder_throw (U"The path goes back in time.");
+static void DTW_Path_recode_raw (SampledXY me, constvector <structDTW_Path> const& path, DTW_Path_Query thee) {
+	integer nxy;		// current number of elements in recoded path
+	integer nsc_x = 1;	// current number of successive horizontal cells in the cells chain
+	integer nsc_y = 1;	// current number of successive vertical cells in the cells chain
+	integer nd = 0;	// current number of successive diagonal cells in the cells chain
+	bool yDirection = false;	// previous segment in the original path was vertical
+	bool xDirection = false;	// previous segment in the original path was horizontal
+	integer ixp = 0, iyp = 0; // previous cell
+	struct structPoint {
+		double x,y;
+	};
+
+	// 1. Starting point always at origin
+	
+	const integer nxymax = thy nx + thy ny + 2;
+	autovector <structPoint> xytimes = newvectorzero <structPoint> (nxymax);
+	xytimes [1]. x = my xmin;
+	xytimes [1]. y = my ymin;
+	
+	// 2. next point lower left of first cell
+	
+	nsc_x = path [1]. x;
+	ixp = nsc_x - 1;
+	xytimes [2]. x = my x1 + (nsc_x - 1 - 0.5) * my dx;
+	nsc_y = path [1]. y;
+	iyp = nsc_y - 1;
+	xytimes [2]. y = my y1 + (nsc_y - 1 - 0.5) * my dy;
+	
+	// 3. follow all cells. implicit: my x1 - 0.5 * my dx > my xmin && my y1 - 0.5 * my dy > my ymin */
+	
+	nxy = 2;
+	for (integer j = 1; j <= path.size; j ++) {
+		const integer ix = path [j]. x, iy = path [j]. y;
+		const double xright = my x1 + (ix - 1 + 0.5) * my dx;
+		const double ytop = my y1 + (iy - 1 + 0.5) * my dy;
+		double x, y, f;
+		integer index; // where are we in the new path?
+
+		if (iy == iyp) { // horizontal path?
+			xDirection = true;
+			if (yDirection) {
+				// We came from a vertical direction so this is the second horizontal cell in a row.
+				// The statement after this "if" updates nsc_x to 2.
+				nsc_x = 1;
+				yDirection = false;
+			}
+			nsc_x ++;
+
+			if (nsc_y > 1 || nd > 1) {
+				// Previous segment was diagonal or vertical: modify intersection
+				// The vh intersection (x,y) = (nsc_x*dx, dy) * (nsc_y-1)/(nsc_x*nsc_y-1)
+				// A diagonal segment has nsc_y = 1.
+				f = (nsc_y - 1.0) / (nsc_x * nsc_y - 1);
+				x = xright - nsc_x * my dx + nsc_x * my dx * f;
+				y = ytop - my dy + my dy * f;
+				index = nxy - 1;
+				if (nsc_x == 2)
+					index = nxy ++;
+
+				xytimes [index]. x = x;
+				xytimes [index]. y = y;
+			}
+			nd = 0;
+		} else if (ix == ixp) { // vertical
+			yDirection = true;
+			if (xDirection) {
+				nsc_y = 1;
+				xDirection = false;
 			}
-			// update
-			xytimes [nxy]. x = xright;
-			xytimes [nxy]. y = ytop;
-			ixp = ix;
-			iyp = iy;
+			nsc_y ++;
+
+			if (nsc_x > 1 || nd > 1) {
+				// The hv intersection (x,y) = (dx, dy*nsc_y ) * (nsc_x-1)/(nsc_x*nsc_y-1)
+				f = (nsc_x - 1.0) / (nsc_x * nsc_y - 1);
+				x = xright - my dx + my dx * f;
+				y = ytop - nsc_y * my dy + nsc_y * my dy * f;
+				index = nxy - 1;
+				if (nsc_y == 2)
+					index = nxy ++;
+				xytimes [index]. x = x;
+				xytimes [index]. y = y;
+			}
+			nd = 0;
+		} else if (ix == ixp + 1 && iy == iyp + 1) {   // diagonal
+			nd ++;
+			if (nd == 1)
+				nxy ++;
+			nsc_x = nsc_y = 1;
+		} else {
+			Melder_throw (U"The path goes back in time.");
 		}
+		// update
+		xytimes [nxy]. x = xright;
+		xytimes [nxy]. y = ytop;
+		ixp = ix;
+		iyp = iy;
+	}
 
-		if (my xmax > xytimes [nxy].x || my ymax > xytimes [nxy].y) {
-			xytimes [++ nxy]. x = my xmax;
-			xytimes [nxy]. y = my ymax;
-		}
-		Melder_assert (nxy <= 2 * std::max (my ny, my nx) + 2);
-		
-		thy nxy = nxy;
-		thy yfromx = RealTier_create (my xmin, my xmax);
-		thy xfromy = RealTier_create (my ymin, my ymax);
-		for (integer i = 1; i <= nxy; i ++) {
-			RealTier_addPoint (thy yfromx.get(), xytimes [i]. x, xytimes [i]. y);
-			RealTier_addPoint (thy xfromy.get(), xytimes [i]. y, xytimes [i]. x);
-		}
+	if (my xmax > xytimes [nxy].x || my ymax > xytimes [nxy].y) {
+		xytimes [++ nxy]. x = my xmax;
+		xytimes [nxy]. y = my ymax;
+	}
+	Melder_assert (nxy <= 2 * std::max (my ny, my nx) + 2);
+	
+	thy nxy = nxy;
+	thy yfromx = RealTier_create (my xmin, my xmax);
+	thy xfromy = RealTier_create (my ymin, my ymax);
+	for (integer i = 1; i <= nxy; i ++) {
+		RealTier_addPoint (thy yfromx.get(), xytimes [i]. x, xytimes [i]. y);
+		RealTier_addPoint (thy xfromy.get(), xytimes [i]. y, xytimes [i]. x);
+	}
+}
+
+void DTW_Path_recode (DTW me) {
+	try {
+		DTW_Path_recode_raw (me, my path.part (1, my pathLength), & my pathQuery);
 	} catch (MelderError) {
 		Melder_throw (me, U": not recoded.");
 	}
@@ -785,37 +788,58 @@ void DTW_drawDistancesAlongPath (DTW me, Graphics g, double xmin, double xmax, d
 }
 
 /*
-	metric = 1...n (sum (a_i^n))^(1/n)
+	metric = 1...n (sum (a_i^n))^(1/n), divided by the number of coefficients.
+	The frames are rows here, so that the coefficients are contiguous in memory.
 */
+static double DTW_getFrameDistance (constVEC const& x, constVEC const& y, double metric) {
+	const integer n = x.size;
+	if (metric == 1.0) {
+		double d = 0.0;
+		for (integer k = 1; k <= n; k ++)
+			d += fabs (x [k] - y [k]);
+		return d / n;
+	}
+	if (metric == 2.0) {
+		double d = 0.0;
+		for (integer k = 1; k <= n; k ++) {
+			const double dtmp = x [k] - y [k];
+			d += dtmp * dtmp;
+		}
+		return sqrt (d) / n;
+	}
+	/*
+		First divide distance by maximum to prevent overflow when metric
+		is a large number.
+		d = (x^n)^(1/n) may overflow if x>1 & n >>1 even if d would not overflow!
+	*/
+	double dmax = 0.0, d = 0.0;
+	for (integer k = 1; k <= n; k ++) {
+		const double dtmp = fabs (x [k] - y [k]);
+		if (dtmp > dmax)
+			dmax = dtmp;
+	}
+	if (dmax > 0) {
+		for (integer k = 1; k <= n; k ++) {
+			const double dtmp = fabs (x [k] - y [k]) / dmax;
+			d +=  pow (dtmp, metric);
+		}
+	}
+	d = dmax * pow (d, 1.0 / metric);
+	return d / n; // == d * dy / ymax
+}
+
 autoDTW Matrices_to_DTW (Matrix me, Matrix thee, bool matchStart, bool matchEnd, int slope, double metric) {
 	try {
 		Melder_require (thy ny == my ny,
 			U"Column sizes should be equal.");
 
 		autoDTW him = DTW_create (my xmin, my xmax, my nx, my dx, my x1, thy xmin, thy xmax, thy nx, thy dx, thy x1);
+		autoMAT myFrames = transpose_MAT (my z.get());
+		autoMAT thyFrames = transpose_MAT (thy z.get());
 		autoMelderProgress progess (U"Calculate distances");
 		for (integer i = 1; i <= my nx; i ++) {
-			for (integer j = 1; j <= thy nx; j ++) {
-				/*
-					First divide distance by maximum to prevent overflow when metric
-					is a large number.
-					d = (x^n)^(1/n) may overflow if x>1 & n >>1 even if d would not overflow!
-				*/
-				double dmax = 0.0, d = 0.0;
-				for (integer k = 1; k <= my ny; k ++) {
-					const double dtmp = fabs (my z [k] [i] - thy z [k] [j]);
-					if (dtmp > dmax)
-						dmax = dtmp;
-				}
-				if (dmax > 0) {
-					for (integer k = 1; k <= my ny; k ++) {
-						const double dtmp = fabs (my z [k] [i] - thy z [k] [j]) / dmax;
-						d +=  pow (dtmp, metric);
-					}
-				}
-				d = dmax * pow (d, 1.0 / metric);
-				his z [i] [j] = d / my ny; // == d * dy / ymax
-			}
+			for (integer j = 1; j <= thy nx; j ++)
+				his z [i] [j] = DTW_getFrameDistance (myFrames.row (i), thyFrames.row (j), metric);
 			if ((i % 10) == 1) {
 				Melder_progress (0.999 * i / my nx, U"Calculate distances: column ", i, U" from ", my nx, U".");
 			}
@@ -827,26 +851,25 @@ autoDTW Matrices_to_DTW (Matrix me, Matrix thee, bool matchStart, bool matchEnd,
 	}
 }
 
+/*
+	The spectrogram in dB's (4e-10 scaling not necessary), as a Matrix.
+*/
+static autoMatrix Spectrogram_to_Matrix_dB (Spectrogram me) {
+	autoMatrix thee = Spectrogram_to_Matrix (me);
+	for (integer i = 1; i <= my ny; i ++) {
+		for (integer j = 1; j <= my nx; j ++)
+			thy z [i] [j] = 10.0 * log10 (thy z [i] [j]);
+	}
+	return thee;
+}
+
 autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart, bool matchEnd, int slope, double metric) {
 	try {
 		Melder_require (my xmin == thy xmin && my ymax == thy ymax && my ny == thy ny,
 			U"The number of frequencies and/or frequency ranges should be equal.");
 
-		autoMatrix m1 = Spectrogram_to_Matrix (me);
-		autoMatrix m2 = Spectrogram_to_Matrix (thee);
-
-		/*
-			Take log10 for dB's (4e-10 scaling not necessary)
-		*/
-		for (integer i = 1; i <= my ny; i ++) {
-			for (integer j = 1; j <= my nx; j ++)
-				m1 -> z [i] [j] = 10.0 * log10 (m1 -> z [i] [j]);
-		}
-		for (integer i = 1; i <= thy ny; i ++) {
-			for (integer j = 1; j <= thy nx; j ++)
-				m2 -> z [i] [j] = 10.0 * log10 (m2 -> z [i] [j]);
-		}
-
+		autoMatrix m1 = Spectrogram_to_Matrix_dB (me);
+		autoMatrix m2 = Spectrogram_to_Matrix_dB (thee);
 		autoDTW him = Matrices_to_DTW (m1.get(), m2.get(), matchStart, matchEnd, slope, metric);
 		return him;
 	} catch (MelderError) {
@@ -991,7 +1014,7 @@ autoMatrix DTW_to_Matrix_cumulativeDistances (DTW me, double sakoeChibaBand, int
     }
 }
 
-static void DTW_relaxConstraints (DTW me, double band, int /* slope */, double *relaxedBand, int *relaxedSlope) {
+static void DTW_relaxConstraints (SampledXY me, double band, int /* slope */, double *relaxedBand, int *relaxedSlope) {
 
 	//double dtw_slope = (my ymax - my ymin - band) / (my xmax - my xmin - band);
 	//dtw_slope = dtw_slope+1.0; // fake instruction to avoid compiler warning
@@ -999,7 +1022,7 @@ static void DTW_relaxConstraints (DTW me, double band, int /* slope */, double *
 	*relaxedSlope = 1;
 }
 
-static void DTW_checkSlopeConstraints (DTW me, double band, int slope) {
+static void DTW_checkSlopeConstraints (SampledXY me, double band, int slope) {
     try {
         const double slopes [5] = { DTW_BIG, DTW_BIG, 3.0, 2.0, 1.5 } ;
         double dtw_slope = (my ymax - my ymin - band) / (my xmax - my xmin - band);
@@ -1021,48 +1044,67 @@ static void DTW_checkSlopeConstraints (DTW me, double band, int slope) {
     }
 }
 
+static void DTW_Polygon_checkOverlap (SampledXY me, Polygon thee) {
+	double xmin, xmax, ymin, ymax;
+	Polygon_getExtrema (thee, & xmin, & xmax, & ymin, & ymax);
+	// if the Polygon and the DTW don't overlap everything is unreachable!
+	Melder_require (! (xmax <= my xmin || xmin >= my xmax || ymax <= my ymin || ymin >= my ymax),
+		U"DTW and Polygon don't overlap.");
+}
+
+/*
+	The rows of column ix that the Polygon leaves reachable, clipped to the range [minimumRow, maximumRow]:
+	going up (and down) from the diagonal, everything from the first point outside the Polygon on is unreachable.
+	Only the rows within the clipping range are visited.
+*/
+static void DTW_Polygon_getReachableRows (SampledXY me, Polygon thee, integer ix, integer minimumRow, integer maximumRow,
+	integer *out_lowRow, integer *out_highRow)
+{
+	const double eps = my dx / 100.0;   // safe enough
+	const double dtw_slope = (my ymax - my ymin) / (my xmax - my xmin);
+	const double x = my x1 + (ix - 1) * my dx;
+	// find border "above" polygon
+	integer highRow = maximumRow;
+	const integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy)) + 1;
+	for (integer iy = iystart + 1; iy <= maximumRow; iy ++) {
+		const double y = my y1 + (iy - 1) * my dy;
+		if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
+			highRow = iy - 1;
+			break;
+		}
+	}
+	// find border "below" polygon
+	integer lowRow = minimumRow;
+	if (ix > 1) {
+		integer iystart2 = Melder_ifloor (dtw_slope * ix * (my dx / my dy));   // start 1 lower
+		if (iystart2 > my ny)
+			iystart2 = my ny;
+		for (integer iy = iystart2 - 1; iy >= minimumRow; iy --) {
+			const double y = my y1 + (iy - 1) * my dy;
+			if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
+				lowRow = iy + 1;
+				break;
+			}
+		}
+	}
+	*out_lowRow = lowRow;
+	*out_highRow = highRow;
+}
+
 static void DTW_Polygon_setUnreachableParts (DTW me, Polygon thee, INTMAT const& psi) {
-    try {
-        const double eps = my dx / 100.0;   // safe enough
-        const double dtw_slope = (my ymax - my ymin) / (my xmax - my xmin);
-
-        double xmin, xmax, ymin, ymax;
-        Polygon_getExtrema (thee, & xmin, & xmax, & ymin, & ymax);
-        // if the Polygon and the DTW don't overlap everything is unreachable!
-		Melder_require (! (xmax <= my xmin || xmin >= my xmax || ymax <= my ymin || ymin >= my ymax),
-			U"DTW and Polygon don't overlap.");
-
-        // find border "above" polygon
-        for (integer ix = 1; ix <= my nx; ix ++) {
-            const double x = my x1 + (ix - 1) * my dx;
-            const integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy)) + 1;
-            for (integer iy = iystart + 1; iy <= my ny; iy ++) {
-				const double y = my y1 + (iy - 1) * my dy;
-                if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
-                    for (integer k = iy; k <= my ny; k ++)
-                        psi [k] [ix] = DTW_UNREACHABLE;
-                    break;
-                }
-            }
-        }
-        // find border "below" polygon
-        for (integer ix = 2; ix <= my nx; ix ++) {
-            const double x = my x1 + (ix - 1) * my dx;
-            integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy));   // start 1 lower
-            if (iystart > my ny)
-				iystart = my ny;
-            for (integer iy = iystart - 1; iy >= 1; iy --) {
-                const double y = my y1 + (iy - 1) * my dy;
-                if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
-                    for (integer k = iy; k >= 1; k --)
-                        psi [k] [ix] = DTW_UNREACHABLE;
-                    break;
-                }
-            }
-        }
-    } catch (MelderError) {
-        Melder_throw (me, U" cannot set unreachable parts.");
-    }
+	try {
+		DTW_Polygon_checkOverlap (me, thee);
+		for (integer ix = 1; ix <= my nx; ix ++) {
+			integer lowRow, highRow;
+			DTW_Polygon_getReachableRows (me, thee, ix, 1, my ny, & lowRow, & highRow);
+			for (integer k = highRow + 1; k <= my ny; k ++)
+				psi [k] [ix] = DTW_UNREACHABLE;
+			for (integer k = lowRow - 1; k >= 1; k --)
+				psi [k] [ix] = DTW_UNREACHABLE;
+		}
+	} catch (MelderError) {
+		Melder_throw (me, U" cannot set unreachable parts.");
+	}
 }
 
 #define DTW_ISREACHABLE(y,x) ((psi [y] [x] != DTW_UNREACHABLE) && (psi [y] [x] != DTW_FORBIDDEN))
@@ -1084,7 +1126,7 @@ static void getIntersectionPoint (double x1, double y1, double x2, double y2, do
 	*y3 = a * *x3 + y1 - a * x1;
 }
 
-autoPolygon DTW_to_Polygon (DTW me, double band, int slope) {
+static autoPolygon SampledXY_to_Polygon_band (SampledXY me, double band, int slope) {
     try {
 		try {
 			DTW_checkSlopeConstraints (me, band, slope);
@@ -1193,6 +1235,14 @@ autoPolygon DTW_to_Polygon (DTW me, double band, int slope) {
                 return thee;
             }
         }
+    } catch (MelderError) {
+        Melder_throw (U"No Polygon created.");
+    }
+}
+
+autoPolygon DTW_to_Polygon (DTW me, double band, int slope) {
+    try {
+        return SampledXY_to_Polygon_band (me, band, slope);
     } catch (MelderError) {
         Melder_throw (me, U" no Polygon created.");
     }
@@ -1437,4 +1487,321 @@ void DTW_Polygon_findPathInside (DTW me, Polygon thee, int localSlope, autoMatri
 	}
 }
 
+/********** Banded DTW, with distances computed on the fly **********/
+
+/*
+	The same path as DTW_Polygon_findPathInside would find, but without a full distance matrix.
+	Column ix of the grid (ny rows, nx columns) is reachable from row lowRow [ix] to row highRow [ix];
+	only for this band are the local directions stored; the local and cumulative distances
+	are stored for the last four columns only, since the slope constraints look back three columns at most.
+*/
+template <typename DISTANCE>
+static autovector <structDTW_Path> DTW_findPathInBand (integer nx, integer ny, constINTVEC const& lowRow, constINTVEC const& highRow,
+	int localSlope, DISTANCE distance)
+{
+	const double slopes [5] = { DTW_BIG, DTW_BIG, 3.0, 2.0, 1.5 };
+	const integer delta_xy = std::min (nx, ny) / 10;
+	const integer rowto = std::min (( localSlope != 1 ? Melder_ifloor (slopes [localSlope]) + 1 : delta_xy ), ny);
+	const integer colto = std::min (( localSlope != 1 ? Melder_ifloor (slopes [localSlope]) + 1 : delta_xy ), nx);
+
+	autoINTVEC offset = raw_INTVEC (nx + 1);
+	offset [1] = 0;
+	for (integer ix = 1; ix <= nx; ix ++)
+		offset [ix + 1] = offset [ix] + std::max (0_integer, highRow [ix] - lowRow [ix] + 1);
+	autovector <signed char> directions = newvectorraw <signed char> (offset [nx + 1]);
+	auto inBand = [&] (integer iy, integer ix) {
+		return iy >= lowRow [ix] && iy <= highRow [ix];
+	};
+	auto psi = [&] (integer iy, integer ix) -> signed char& {
+		return directions [offset [ix] + iy - lowRow [ix] + 1];
+	};
+	auto isReachable = [&] (integer iy, integer ix) {
+		if (! inBand (iy, ix))
+			return false;
+		const int direction = psi (iy, ix);
+		return direction != DTW_UNREACHABLE && direction != DTW_FORBIDDEN;
+	};
+	autoMAT localDistances = raw_MAT (4, ny), cumulativeDistances = raw_MAT (4, ny);
+	auto z = [&] (integer iy, integer ix) -> double& {
+		return localDistances [(ix + 3) % 4 + 1] [iy];
+	};
+	auto delta = [&] (integer iy, integer ix) -> double& {
+		return cumulativeDistances [(ix + 3) % 4 + 1] [iy];
+	};
+
+	/*
+		The begin parts of the first column and the first row are cumulated over the whole grid,
+		as in DTW_Polygon_findPathInside, where this happens before the band is applied.
+	*/
+	double firstColumnSum = distance (1, 1), firstRowSum = firstColumnSum;
+	integer numberOfIsolatedPoints = 0;
+	autoMelderProgress progress (U"Find path");
+	for (integer j = 1; j <= nx; j ++) {
+		for (integer i = lowRow [j]; i <= highRow [j]; i ++) {
+			z (i, j) = delta (i, j) = distance (i, j);
+			psi (i, j) = ( i == 1 || j == 1 ? DTW_UNREACHABLE : 0 );
+		}
+		if (j == 1) {
+			for (integer iy = 2; iy <= rowto; iy ++) {
+				if (localSlope != 1)
+					firstColumnSum += ( inBand (iy, 1) ? z (iy, 1) : distance (iy, 1) );
+				if (inBand (iy, 1)) {
+					psi (iy, 1) = ( localSlope != 1 ? DTW_Y : DTW_START );
+					if (localSlope != 1)
+						delta (iy, 1) = firstColumnSum;
+				}
+			}
+			continue;
+		}
+		if (j <= colto) {
+			if (localSlope != 1)
+				firstRowSum += ( inBand (1, j) ? z (1, j) : distance (1, j) );
+			if (inBand (1, j)) {
+				psi (1, j) = ( localSlope != 1 ? DTW_X : DTW_START );
+				if (localSlope != 1)
+					delta (1, j) = firstRowSum;
+			}
+		}
+		for (integer i = std::max (2_integer, lowRow [j]); i <= highRow [j]; i ++) {
+			double g, gmin = DTW_BIG;
+			integer direction = 0;
+			if (isReachable (i - 1, j - 1)) {
+				gmin = delta (i - 1, j - 1) + 2.0 * z (i, j);
+				direction = DTW_XANDY;
+			} else if (isReachable (i, j - 1)) {
+				gmin = delta (i, j - 1) + z (i, j);
+				direction = DTW_X;
+			} else if (isReachable (i - 1, j)) {
+				gmin = delta (i - 1, j) + z (i, j);
+				direction = DTW_Y;
+			} else {
+				numberOfIsolatedPoints ++;
+				continue;
+			}
+			auto psiIs = [&] (integer iy, integer ix, int value) {
+				return inBand (iy, ix) && psi (iy, ix) == value;
+			};
+			switch (localSlope) {
+			case 1: {   // no restriction
+				if (isReachable (i, j - 1) && ((g = delta (i, j - 1) + z (i, j)) < gmin)) {
+					gmin = g;
+					direction = DTW_X;
+				}
+				if (isReachable (i - 1, j) && ((g = delta (i - 1, j) + z (i, j)) < gmin)) {
+					gmin = g;
+					direction = DTW_Y;
+				}
+			}
+			break;
+			case 2: {   // P = 1/2
+				if (j >= 4 && isReachable (i - 1, j - 3) && psiIs (i, j - 1, DTW_X) && psiIs (i, j - 2, DTW_XANDY) &&
+					(g = delta (i - 1, j - 3) + 2.0 * z (i, j - 2) + z (i, j - 1) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_X;
+				}
+				if (j >= 3 && isReachable (i - 1, j - 2) && psiIs (i, j - 1, DTW_XANDY) &&
+					(g = delta (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_X;
+				}
+				if (i >= 3 && isReachable (i - 2, j - 1) && psiIs (i - 1, j, DTW_XANDY) &&
+					(g = delta (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_Y;
+				}
+				if (i >= 4 && isReachable (i - 3, j - 1) && psiIs (i - 1, j, DTW_Y) && psiIs (i - 2, j, DTW_XANDY) &&
+					(g = delta (i - 3, j - 1) + 2.0 * z (i - 2, j) + z (i - 1, j) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_Y;
+				}
+			}
+			break;
+			case 3: {   // P = 1
+				if (j >= 3 && isReachable (i - 1, j - 2) && psiIs (i, j - 1, DTW_XANDY) &&
+					(g = delta (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_X;
+				}
+				if (i >= 3 && isReachable (i - 2, j - 1) && psiIs (i - 1, j, DTW_XANDY) &&
+					(g = delta (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_Y;
+				}
+			}
+			break;
+			case 4: {   // P = 2
+				if (i >= 3 && j >= 4 && isReachable (i - 2, j - 3) && psiIs (i, j - 1, DTW_XANDY) && psiIs (i - 1, j - 2, DTW_XANDY) &&
+					(g = delta (i - 2, j - 3) + 2.0 * z (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_X;
+				}
+				if (i >= 4 && j >= 3 && isReachable (i - 3, j - 2) && psiIs (i - 1, j, DTW_XANDY) && psiIs (i - 2, j - 1, DTW_XANDY) &&
+					(g = delta (i - 3, j - 2) + 2.0 * z (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin) {
+					gmin = g;
+					direction = DTW_Y;
+				}
+			}
+			break;
+			default:
+			break;
+			}
+			Melder_assert (direction != 0);
+			psi (i, j) = direction;
+			delta (i, j) = gmin;
+		}
+		if (j % 10 == 2)
+			Melder_progress (0.999 * j / nx, U"Calculate time warp: frame ", j, U" from ", nx, U".");
+	}
+
+	/*
+		Find minimum at end of path and trace back.
+		The search starts at the top of the band, which is the top row unless the band was narrowed by a multiscale search.
+	*/
+	integer iy = Melder_clipped (1_integer, highRow [nx], ny);
+	double minimum = ( inBand (iy, nx) ? delta (iy, nx) : distance (iy, nx) );
+	for (integer i = iy - 1; i > 0; i --) {
+		if (! isReachable (i, nx)) {
+			break;   // we're in unreachable places
+		} else if (delta (i, nx) < minimum) {
+			minimum = delta (iy = i, nx);
+		}
+	}
+	autovector <structDTW_Path> path = newvectorzero <structDTW_Path> (nx + ny - 1);
+	integer pathIndex = nx + ny - 1;   // maximum path length
+	path [pathIndex]. y = iy;
+	integer ix = path [pathIndex]. x = nx;
+	while (ix > 1) {
+		const int direction = ( inBand (iy, ix) ? psi (iy, ix) : DTW_UNREACHABLE );
+		if (direction == DTW_XANDY) {
+			ix --;
+			iy --;
+		} else if (direction == DTW_X) {
+			ix --;
+		} else if (direction == DTW_Y) {
+			iy --;
+		} else if (direction == DTW_START) {
+			break;
+		}
+		if (pathIndex < 2 || iy < 1)
+			break;
+		path [-- pathIndex]. x = ix;
+		path [pathIndex]. y = iy;
+	}
+	const integer pathLength = nx + ny - 1 - pathIndex + 1;
+	if (pathIndex > 1)
+		for (integer j = 1; j <= pathLength; j ++)
+			path [j] = path [pathIndex ++];
+	path.resize (pathLength);
+	return path;
+}
+
+static autoMAT DTW_halveFrames (constMAT const& frames) {
+	autoMAT result = raw_MAT ((frames.nrow + 1) / 2, frames.ncol);
+	for (integer irow = 1; irow <= result.nrow; irow ++) {
+		const integer secondRow = std::min (2 * irow, frames.nrow);
+		for (integer icol = 1; icol <= frames.ncol; icol ++)
+			result [irow] [icol] = 0.5 * (frames [2 * irow - 1] [icol] + frames [secondRow] [icol]);
+	}
+	return result;
+}
+
+/*
+	The frames of `grid` are the rows of yFrames (prototype) and xFrames (test).
+	With a positive multiscaleRadius, the path is first found for frames of half the resolution (recursively);
+	the band is then narrowed to the cells around that path, widened by multiscaleRadius frames.
+*/
+static autovector <structDTW_Path> DTW_findPathInBand_multiscale (SampledXY grid, constMAT const& yFrames, constMAT const& xFrames,
+	Polygon polygon, int localSlope, double metric, integer multiscaleRadius)
+{
+	constexpr integer minimumNumberOfFrames = 100;
+	const integer nx = grid -> nx, ny = grid -> ny;
+	autoINTVEC minimumRow = raw_INTVEC (nx), maximumRow = raw_INTVEC (nx);
+	for (integer ix = 1; ix <= nx; ix ++) {
+		minimumRow [ix] = 1;
+		maximumRow [ix] = ny;
+	}
+	if (multiscaleRadius > 0 && std::min (nx, ny) >= 2 * std::max (minimumNumberOfFrames, multiscaleRadius)) {
+		autoSampledXY coarseGrid = Thing_new (SampledXY);
+		SampledXY_init (coarseGrid.get(), grid -> xmin, grid -> xmax, (nx + 1) / 2, 2.0 * grid -> dx, grid -> x1 + 0.5 * grid -> dx,
+				grid -> ymin, grid -> ymax, (ny + 1) / 2, 2.0 * grid -> dy, grid -> y1 + 0.5 * grid -> dy);
+		autoMAT coarseYFrames = DTW_halveFrames (yFrames), coarseXFrames = DTW_halveFrames (xFrames);
+		autovector <structDTW_Path> coarsePath = DTW_findPathInBand_multiscale (coarseGrid.get(), coarseYFrames.get(), coarseXFrames.get(),
+				polygon, localSlope, metric, multiscaleRadius);
+		/*
+			Project the coarse path onto the fine grid...
+		*/
+		autoINTVEC pathLow = raw_INTVEC (nx), pathHigh = zero_INTVEC (nx);
+		for (integer ix = 1; ix <= nx; ix ++)
+			pathLow [ix] = ny + 1;
+		for (integer ipath = 1; ipath <= coarsePath.size; ipath ++) {
+			const integer ix = coarsePath [ipath]. x, iy = coarsePath [ipath]. y;
+			for (integer jx = 2 * ix - 1; jx <= std::min (2 * ix, nx); jx ++) {
+				Melder_clipRight (& pathLow [jx], 2 * iy - 1);
+				Melder_clipLeft (std::min (2 * iy, ny), & pathHigh [jx]);
+			}
+		}
+		/*
+			... and widen it by the radius in both directions.
+		*/
+		for (integer ix = 1; ix <= nx; ix ++) {
+			integer low = ny + 1, high = 0;
+			for (integer jx = std::max (1_integer, ix - multiscaleRadius); jx <= std::min (nx, ix + multiscaleRadius); jx ++) {
+				Melder_clipRight (& low, pathLow [jx]);
+				Melder_clipLeft (pathHigh [jx], & high);
+			}
+			minimumRow [ix] = std::max (1_integer, low - multiscaleRadius);
+			maximumRow [ix] = std::min (ny, high + multiscaleRadius);
+		}
+	}
+	autoINTVEC lowRow = raw_INTVEC (nx), highRow = raw_INTVEC (nx);
+	for (integer ix = 1; ix <= nx; ix ++)
+		DTW_Polygon_getReachableRows (grid, polygon, ix, minimumRow [ix], maximumRow [ix], & lowRow [ix], & highRow [ix]);
+	return DTW_findPathInBand (nx, ny, lowRow.get(), highRow.get(), localSlope,
+		[&] (integer iy, integer ix) {
+			return DTW_getFrameDistance (yFrames.row (iy), xFrames.row (ix), metric);
+		}
+	);
+}
+
+autoRealTier Matrices_to_RealTier_timeWarp (Matrix me, Matrix thee, double sakoeChibaBand, int localSlope, double metric,
+	integer multiscaleRadius)
+{
+	try {
+		Melder_require (thy ny == my ny,
+			U"Column sizes should be equal.");
+		Melder_require (localSlope > 0 && localSlope < 5,
+			U"Local slope parameter ", localSlope, U" not supported.");
+		/*
+			The same axes as in Matrices_to_DTW: `me` on the y-axis, `thee` on the x-axis.
+		*/
+		autoSampledXY grid = Thing_new (SampledXY);
+		SampledXY_init (grid.get(), thy xmin, thy xmax, thy nx, thy dx, thy x1, my xmin, my xmax, my nx, my dx, my x1);
+		autoPolygon polygon = SampledXY_to_Polygon_band (grid.get(), sakoeChibaBand, localSlope);
+		autoMAT myFrames = transpose_MAT (my z.get());
+		autoMAT thyFrames = transpose_MAT (thy z.get());
+		autovector <structDTW_Path> path = DTW_findPathInBand_multiscale (grid.get(), myFrames.get(), thyFrames.get(),
+				polygon.get(), localSlope, metric, multiscaleRadius);
+		structDTW_Path_Query query;
+		DTW_Path_Query_init (& query, my nx, thy nx);
+		DTW_Path_recode_raw (grid.get(), path.get(), & query);
+		return query.xfromy.move();
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": no time warp created.");
+	}
+}
+
+autoRealTier Spectrograms_to_RealTier_timeWarp (Spectrogram me, Spectrogram thee, double sakoeChibaBand, int localSlope,
+	integer multiscaleRadius)
+{
+	try {
+		Melder_require (my xmin == thy xmin && my ymax == thy ymax && my ny == thy ny,
+			U"The number of frequencies and/or frequency ranges should be equal.");
+		autoMatrix m1 = Spectrogram_to_Matrix_dB (me);
+		autoMatrix m2 = Spectrogram_to_Matrix_dB (thee);
+		return Matrices_to_RealTier_timeWarp (m1.get(), m2.get(), sakoeChibaBand, localSlope, 1.0, multiscaleRadius);
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": no time warp created.");
+	}
+}
+
 /* End of file DTW.cpp */
@@ -117,6 +117,21 @@ autoDTW Matrices_to_DTW (Matrix me, Matrix thee, bool matchStart, bool matchEnd,
 
 autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart, bool matchEnd, int slope, double metric);
 
+autoRealTier Matrices_to_RealTier_timeWarp (Matrix me, Matrix thee, double sakoeChibaBand, int localSlope, double metric,
+	integer multiscaleRadius);
+/*
+	The times in `thee` as a function of the times in `me`, along the same path that
+	Matrices_to_DTW followed by DTW_findPath_bandAndSlope would find,
+	but without the (my nx x thy nx) distance matrix: the distances are computed only inside the band,
+	so that memory and time are proportional to the area of the band.
+	If multiscaleRadius > 0, the path is first found at half the time resolution (recursively),
+	and the band is restricted to within multiscaleRadius frames of that path;
+	this is faster but need not find the optimal path.
+*/
+
+autoRealTier Spectrograms_to_RealTier_timeWarp (Spectrogram me, Spectrogram thee, double sakoeChibaBand, int localSlope,
+	integer multiscaleRadius);
+
 autoDTW Pitches_to_DTW (Pitch me, Pitch thee, double vuv_costs, double time_weight, bool matchStart, bool matchEnd, int slope);
 
 autoDurationTier DTW_to_DurationTier (DTW me);
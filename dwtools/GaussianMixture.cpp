@@ -24,6 +24,7 @@
 #include "NUMmachar.h"
 #include "NUM2.h"
 #include "Strings_extensions.h"
+#include "MelderThread.h"
 
 #include "oo_DESTROY.h"
 #include "GaussianMixture_def.h"
@@ -155,6 +156,137 @@ static void GaussianMixture_getResponsibilities (GaussianMixture me, constMATVU
 	MATnormalizeRows_inplace (responsibilities, 1.0, 1.0);
 }
 
+/*
+	The E-step and the M-step handle the data in blocks of rows.
+	The Mahalanobis distances of all the rows in a block to the centroid of a full-covariance component
+	follow from a single matrix multiplication:
+		transformed = (data - centroid) . L⁻¹'
+	where L is the lower Cholesky factor of the covariance matrix, so that dsq [i] = sum (transformed [i] [.]^2).
+	The M-step sums the weighted data of each stretch of blocks (see MelderThread_runInStretches) separately,
+	and then adds up the stretch sums in stretch order.
+*/
+
+constexpr integer GaussianMixture_BLOCK_SIZE = 256;
+constexpr integer GaussianMixture_MAXIMUM_NUMBER_OF_STRETCHES = 64;
+
+Thing_define (GaussianMixture_Workspace, Thing) { public:
+	autoMAT centred, transformed;   // [1..GaussianMixture_BLOCK_SIZE] [1..dimension]
+	autoMAT logDensities;   // [1..GaussianMixture_BLOCK_SIZE] [1..numberOfComponents]
+	autoMAT scatter;   // [1..dimension] [1..dimension]
+};
+
+Thing_implement (GaussianMixture_Workspace, Thing, 0);
+
+static autoGaussianMixture_Workspace GaussianMixture_Workspace_create (GaussianMixture me) {
+	autoGaussianMixture_Workspace thee = Thing_new (GaussianMixture_Workspace);
+	thy centred = zero_MAT (GaussianMixture_BLOCK_SIZE, my dimension);
+	thy transformed = zero_MAT (GaussianMixture_BLOCK_SIZE, my dimension);
+	thy logDensities = zero_MAT (GaussianMixture_BLOCK_SIZE, my numberOfComponents);
+	thy scatter = zero_MAT (my dimension, my dimension);
+	return thee;
+}
+
+static integer GaussianMixture_getNumberOfStretches (integer numberOfRows) {
+	return MelderThread_computeNumberOfStretches (numberOfRows, GaussianMixture_BLOCK_SIZE, GaussianMixture_MAXIMUM_NUMBER_OF_STRETCHES);
+}
+
+/*
+	Runs `analyseBlock` for the blocks of rows (see MelderThread_runInStretches),
+	each thread with a workspace of its own.
+*/
+static void GaussianMixture_runBlocks (GaussianMixture me, integer numberOfRows,
+	std::function <void (GaussianMixture_Workspace workspace, integer istretch, integer fromRow, integer toRow)> const& analyseBlock)
+{
+	if (numberOfRows == 0)
+		return;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (GaussianMixture_getNumberOfStretches (numberOfRows), 1);
+	OrderedOf <structGaussianMixture_Workspace> workspaces;
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		workspaces. addItem_move (GaussianMixture_Workspace_create (me));
+	MelderThread_runInStretches (numberOfThreads, numberOfRows, GaussianMixture_BLOCK_SIZE, GaussianMixture_MAXIMUM_NUMBER_OF_STRETCHES,
+		[&] (integer ithread, integer istretch, integer fromRow, integer toRow) {
+			analyseBlock (workspaces.at [ithread], istretch, fromRow, toRow);
+		}
+	);
+}
+
+/*
+	E-step.
+	Computes the probability densities of the data for the components from `fromComponent` to `toComponent`
+	(unless `probabilities` is empty), and the responsibilities of all the components (unless `responsibilities` is empty).
+	The responsibilities are normalized in the log domain, so that they remain correct
+	for rows that are so far from all the components that their densities underflow.
+*/
+static void GaussianMixture_computeExpectations (GaussianMixture me, constMATVU const& data, integer fromComponent, integer toComponent,
+	MAT const& probabilities, MAT const& responsibilities)
+{
+	const integer dimension = my dimension;
+	Melder_assert (data.ncol == dimension);
+	Melder_assert (fromComponent >= 1 && toComponent <= my numberOfComponents);
+	Melder_assert (NUMisEmpty (probabilities) || probabilities.nrow == data.nrow && probabilities.ncol == my numberOfComponents);
+	Melder_assert (NUMisEmpty (responsibilities) || responsibilities.nrow == data.nrow && responsibilities.ncol == my numberOfComponents &&
+			fromComponent == 1 && toComponent == my numberOfComponents);
+	const double ln2pid = dimension * log (NUM2pi);
+	/*
+		The transposed inverse Cholesky factors of the full-covariance components, one below the other.
+	*/
+	autoMAT transposedInverses = zero_MAT (my numberOfComponents * dimension, dimension);
+	for (integer component = fromComponent; component <= toComponent; component ++) {
+		const Covariance covariance = my covariances->at [component];
+		SSCP_expandWithLowerCholeskyInverse (covariance);
+		if (covariance -> numberOfRows > 1) {
+			const MATVU transposedInverse = transposedInverses.horizontalBand ((component - 1) * dimension + 1, component * dimension);
+			for (integer irow = 1; irow <= dimension; irow ++)
+				for (integer icol = 1; icol <= irow; icol ++)
+					transposedInverse [icol] [irow] = covariance -> lowerCholeskyInverse [irow] [icol];
+		}
+	}
+	autoVEC logMixingProbabilities = raw_VEC (my numberOfComponents);
+	for (integer component = 1; component <= my numberOfComponents; component ++)
+		logMixingProbabilities [component] = log (my mixingProbabilities [component]);   // -inf for a removed component
+	GaussianMixture_runBlocks (me, data.nrow,
+		[&] (GaussianMixture_Workspace workspace, integer /* istretch */, integer fromRow, integer toRow) {
+			const integer numberOfRows = toRow - fromRow + 1;
+			const MATVU centred = workspace -> centred.horizontalBand (1, numberOfRows);
+			const MATVU transformed = workspace -> transformed.horizontalBand (1, numberOfRows);
+			for (integer component = fromComponent; component <= toComponent; component ++) {
+				const Covariance covariance = my covariances->at [component];
+				centred  <<=  data.part (fromRow, toRow, 1, dimension)  -  covariance -> centroid.get();
+				if (covariance -> numberOfRows == 1)   // the covariance is diagonal, and row 1 of the inverse contains 1 / stddev
+					transformed  <<=  centred  *  covariance -> lowerCholeskyInverse.row (1);
+				else
+					mul_fast_MAT_out (transformed, centred,
+							transposedInverses.horizontalBand ((component - 1) * dimension + 1, component * dimension));
+				const double logNormalization = - 0.5 * (ln2pid + covariance -> lnd);
+				for (integer irow = 1; irow <= numberOfRows; irow ++) {
+					double dsq = 0.0;
+					for (integer icol = 1; icol <= dimension; icol ++)
+						dsq += transformed [irow] [icol] * transformed [irow] [icol];
+					const double logDensity = logNormalization - 0.5 * dsq;
+					if (! NUMisEmpty (probabilities))
+						probabilities [fromRow - 1 + irow] [component] = std::max (1e-300, exp (logDensity)); // prevent probabilities from being zero
+					workspace -> logDensities [irow] [component] = logDensity + logMixingProbabilities [component];
+				}
+			}
+			if (NUMisEmpty (responsibilities))
+				return;
+			for (integer irow = 1; irow <= numberOfRows; irow ++) {
+				const VEC logDensities = workspace -> logDensities.row (irow);
+				const VEC responsibilitiesOfRow = responsibilities.row (fromRow - 1 + irow);
+				double maximum = logDensities [1];
+				for (integer component = 2; component <= my numberOfComponents; component ++)
+					maximum = std::max (maximum, logDensities [component]);
+				for (integer component = 1; component <= my numberOfComponents; component ++)
+					responsibilitiesOfRow [component] = exp (logDensities [component] - maximum);
+				responsibilitiesOfRow  /=  NUMsum (responsibilitiesOfRow);
+			}
+		}
+	);
+}
+
+/*
+	M-step for one component.
+*/
 static void GaussianMixture_updateComponent (GaussianMixture me, integer component, MATVU const& data, MATVU const& responsibilities) {
 	integer numberOfData = data.nrow;
 	Melder_require (my dimension == data.ncol,
@@ -167,35 +299,49 @@ static void GaussianMixture_updateComponent (GaussianMixture me, integer compone
 		U"The component number should be in the range from 1 to ", my numberOfComponents, U".");
 	
 	const Covariance thee = my covariances->at [component];
+	const integer dimension = my dimension;
+	const integer numberOfStretches = GaussianMixture_getNumberOfStretches (numberOfData);
 	/*
 		Update the means: Bishop eq. 9.24
 	*/
+	autoMAT stretchSums = zero_MAT (numberOfStretches, dimension);
+	GaussianMixture_runBlocks (me, numberOfData,
+		[&] (GaussianMixture_Workspace /* workspace */, integer istretch, integer fromRow, integer toRow) {
+			for (integer irow = fromRow; irow <= toRow; irow ++)
+				stretchSums.row (istretch)  +=  responsibilities [irow] [component]  *  data.row (irow);
+		}
+	);
 	thy centroid.all()  <<=  0.0;
-	for (integer irow = 1; irow <= numberOfData; irow ++)
-		thy centroid.get()  +=  responsibilities [irow] [component]  *  data.row (irow);
+	for (integer istretch = 1; istretch <= numberOfStretches; istretch ++)
+		thy centroid.all()  +=  stretchSums.row (istretch);
 	
 	const double totalComponentResponsibility = NUMsum (responsibilities.column (component));
 	thy centroid.get ()  /=  totalComponentResponsibility;
 	/*
 		update covariance with the new mean: Bishop eq. 9.25
 	*/
-	thy data.all()  <<=  0.0;
-	autoVEC dif = raw_VEC (thy numberOfColumns);
-	if (thy numberOfRows == 1) { // 1xn covariance
-		autoVEC variance = raw_VEC (thy numberOfColumns);
-		for (integer irow = 1; irow <= numberOfData; irow ++) {
-			dif.all()  <<=  data.row (irow)  -  thy centroid.get();
-			variance.all()  <<=  dif.all()  *  dif.all();
-			thy data.row (1)  +=  responsibilities [irow] [component]  *  variance.get();
-		}
-	} else { // nxn covariance
-		autoMAT covar = raw_MAT (thy numberOfColumns, thy numberOfColumns);
-		for (integer irow = 1; irow <= numberOfData; irow ++) {
-			dif.all()  <<=  data.row (irow)  -  thy centroid.get();
-			outer_MAT_out (covar.get(), dif.get(), dif.get());
-			thy data.get()  +=  responsibilities [irow] [component]  *  covar.get();
+	const bool isDiagonal = ( thy numberOfRows == 1 );   // 1xn covariance
+	autoMAT stretchScatters = zero_MAT (numberOfStretches * thy numberOfRows, dimension);
+	GaussianMixture_runBlocks (me, numberOfData,
+		[&] (GaussianMixture_Workspace workspace, integer istretch, integer fromRow, integer toRow) {
+			const integer numberOfRows = toRow - fromRow + 1;
+			const MATVU centred = workspace -> centred.horizontalBand (1, numberOfRows);
+			const MATVU weighted = workspace -> transformed.horizontalBand (1, numberOfRows);
+			centred  <<=  data.part (fromRow, toRow, 1, dimension)  -  thy centroid.get();
+			for (integer irow = 1; irow <= numberOfRows; irow ++)
+				weighted.row (irow)  <<=  responsibilities [fromRow - 1 + irow] [component]  *  centred.row (irow);
+			if (isDiagonal) {
+				for (integer irow = 1; irow <= numberOfRows; irow ++)
+					stretchScatters.row (istretch)  +=  weighted.row (irow)  *  centred.row (irow);
+			} else {
+				mul_fast_MAT_out (workspace -> scatter.get(), weighted.transpose (), centred);
+				stretchScatters.horizontalBand ((istretch - 1) * dimension + 1, istretch * dimension)  +=  workspace -> scatter.get();
+			}
 		}
-	}
+	);
+	thy data.all()  <<=  0.0;
+	for (integer istretch = 1; istretch <= numberOfStretches; istretch ++)
+		thy data.all()  +=  stretchScatters.horizontalBand ((istretch - 1) * thy numberOfRows + 1, istretch * thy numberOfRows);
 	thy data.get()  /=  totalComponentResponsibility;
 	thy numberOfObservations = my mixingProbabilities [component] * numberOfData;
 }
@@ -802,20 +948,9 @@ void GaussianMixture_TableOfReal_getComponentProbabilities (GaussianMixture me,
 			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
 		Melder_require (componentToUpdate >= 0 && componentToUpdate <= my numberOfComponents,
 			U"The component number should be in the interval from 0 to ", my numberOfComponents);
-		const double ln2pid = my dimension * log (NUM2pi);
-
 		const integer fromComponent = componentToUpdate == 0 ? 1 : componentToUpdate;
 		const integer toComponent = componentToUpdate == 0 ? my numberOfComponents : componentToUpdate;
-		
-		for (integer component = fromComponent; component <= toComponent; component ++) {
-			const Covariance covi = my covariances->at [component];
-			SSCP_expandWithLowerCholeskyInverse (covi);
-
-			for (integer irow = 1; irow <= thy numberOfRows; irow++) {
-				const double dsq = NUMmahalanobisDistanceSquared (covi -> lowerCholeskyInverse.get(), thy data.row (irow), covi -> centroid.get());
-				probabilities [irow] [component] = std::max (1e-300, exp (- 0.5 * (ln2pid + covi -> lnd + dsq))); // prevent probabilities from being zero
-			}
-		}
+		GaussianMixture_computeExpectations (me, thy data.get(), fromComponent, toComponent, probabilities, MAT ());
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": no component probabilies could be calculated.");
 	}
@@ -828,9 +963,7 @@ void GaussianMixture_TableOfReal_getResponsilities (GaussianMixture me, TableOfR
 			U"The number of columns in the TableOfReal and the responsibilities should be equal.");
 		Melder_require (my dimension == thy numberOfColumns,
 			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
-		autoMAT probabilities = raw_MAT (responsibilities.nrow, responsibilities.ncol);
-		GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities.get());
-		GaussianMixture_getResponsibilities (me, probabilities.get(), 0, responsibilities);
+		GaussianMixture_computeExpectations (me, thy data.get(), 1, my numberOfComponents, MAT (), responsibilities);
 }
 
 autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_probabilities (GaussianMixture me, TableOfReal thee) {
@@ -849,8 +982,12 @@ autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_probabilities (Gaussi
 
 autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_responsibilities (GaussianMixture me, TableOfReal thee) {
 	try {
-		autoTableOfReal him = GaussianMixture_TableOfReal_to_TableOfReal_probabilities (me, thee);
-		GaussianMixture_getResponsibilities (me, his data.get(), 0, his data.get());
+		Melder_require (my dimension == thy numberOfColumns,
+			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
+		autoTableOfReal him = TableOfReal_create (thy numberOfRows, my numberOfComponents);
+		his rowLabels.all()  <<=  thy rowLabels.all();
+		TableOfReal_setSequentialColumnLabels (him.get(), 1, my numberOfComponents, U"c", 1, 1);
+		GaussianMixture_computeExpectations (me, thy data.get(), 1, my numberOfComponents, MAT (), his data.get());
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": no responsibilities could be calculated.");
@@ -888,7 +1025,7 @@ void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfR
 		autoMAT probabilities = raw_MAT (thy numberOfRows, my numberOfComponents);
 		autoMAT responsibilities = raw_MAT (thy numberOfRows, my numberOfComponents);
 		
-		GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities.get());
+		GaussianMixture_computeExpectations (me, thy data.get(), 1, my numberOfComponents, probabilities.get(), responsibilities.get());
 
 		double lnp = GaussianMixture_getLikelihoodValue (me, probabilities.get(), criterion);
 		integer iter = 0;
@@ -898,11 +1035,10 @@ void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfR
 			do {
 				iter ++;
 				/*
-					E-step: get responsibilities (gamma) with current parameters
+					E-step: the responsibilities (gamma) have been computed with the current parameters,
+					together with the probabilities.
 					See C. Bishop (2006), Pattern reconition and machine learning, Springer, page 439...
 				*/
-				GaussianMixture_getResponsibilities (me, probabilities.get(), 0, responsibilities.get());
-
 				lnp_prev = lnp;
 				
 				/*
@@ -920,7 +1056,7 @@ void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfR
 				my mixingProbabilities.all()  <<=  totalResponsibilities.get();
 				my mixingProbabilities.all()  *=  1.0 / responsibilities.nrow;
 				
-				GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities.get());
+				GaussianMixture_computeExpectations (me, thy data.get(), 1, my numberOfComponents, probabilities.get(), responsibilities.get());
 				
 				lnp = GaussianMixture_getLikelihoodValue (me, probabilities.get(), criterion);
 				Melder_progress ((double) iter / (double) maxNumberOfIterations, criterionText, U": ", lnp / thy numberOfRows, U", L0: ", lnp_start);
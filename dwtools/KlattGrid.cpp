@@ -482,10 +482,11 @@ static void _Sound_FormantGrid_filterWithOneFormant_inplace (Sound me, FormantGr
 	else
 		r = Resonator_create (my dx, true);
 
+	const autoVEC formantFrequencies = RealTier_listValuesAtRegularTimes (ftier, my x1, my dx, my nx);
+	const autoVEC formantBandwidths = RealTier_listValuesAtRegularTimes (btier, my x1, my dx, my nx);
 	for (integer is = 1; is <= my nx; is ++) {
-		const double t = my x1 + (is - 1) * my dx;
-		const double f = RealTier_getValueAtTime (ftier, t);
-		const double b = RealTier_getValueAtTime (btier, t);
+		const double f = formantFrequencies [is];
+		const double b = formantBandwidths [is];
 		if (f <= nyquist && isdefined (b))
 			Filter_setCoefficients (r.get(), f, b);
 		my z [1] [is] = Filter_getOutput (r.get(), my z [1] [is]);
@@ -513,13 +514,15 @@ void Sound_FormantGrid_Intensities_filterWithOneFormant_inplace (Sound me, Forma
 		if (ftier -> points.size == 0 || btier -> points.size == 0 || atier -> points.size == 0)
 			return;    // nothing to do
 		autoResonator r = Resonator_create (my dx, false);
+		const autoVEC formantFrequencies = RealTier_listValuesAtRegularTimes (ftier, my x1, my dx, my nx);
+		const autoVEC formantBandwidths = RealTier_listValuesAtRegularTimes (btier, my x1, my dx, my nx);
+		const autoVEC formantIntensities = RealTier_listValuesAtRegularTimes (atier, my x1, my dx, my nx);
 		for (integer is = 1; is <= my nx; is ++) {
-			const double t = my x1 + (is - 1) * my dx;
-			const double f = RealTier_getValueAtTime (ftier, t);
-			const double b = RealTier_getValueAtTime (btier, t);
+			const double f = formantFrequencies [is];
+			const double b = formantBandwidths [is];
 			if (f <= nyquist && isdefined (b)) {
 				Filter_setCoefficients (r.get(), f, b);
-				const double a = RealTier_getValueAtTime (atier, t);
+				const double a = formantIntensities [is];
 				if (isdefined (a))
 					r -> a *= DB_to_A (a);
 			}
@@ -837,10 +840,10 @@ autoSound PhonationGrid_to_Sound_aspiration (PhonationGrid me, double samplingFr
 		// the origin in the z-plane, i.e. y [n] = x [n] + (0.75 * y [n-1])
 		double lastval = 0.0;
 		if (my aspirationAmplitude -> points.size > 0) {
+			const autoVEC aspirationAmplitudes = RealTier_listValuesAtRegularTimes (my aspirationAmplitude.get(), thy x1, thy dx, thy nx);
 			for (integer i = 1; i <= thy nx; i ++) {
-				const double t = thy x1 + (i - 1) * thy dx;
 				double val = NUMrandomUniform (-1.0, 1.0);
-				const double a = DBSPL_to_A (RealTier_getValueAtTime (my aspirationAmplitude.get(), t));
+				const double a = DBSPL_to_A (aspirationAmplitudes [i]);
 				if (isdefined (a)) {
 					thy z [1] [i] = lastval = val + 0.75 * lastval;
 					lastval = (val += 0.75 * lastval); // soft low-pass
@@ -869,9 +872,9 @@ static void Sound_PhonationGrid_spectralTilt_inplace (Sound thee, PhonationGrid
 		const double cosf = cos (NUM2pi * 3000.0 * thy dx); // samplingFrequency > 6000.0 !
 		double ynm1 = 0.0;
 
+		const autoVEC tilts_db = RealTier_listValuesAtRegularTimes (my spectralTilt.get(), thy x1, thy dx, thy nx);
 		for (integer i = 1; i <= thy nx; i ++) {
-			const double t = thy x1 + (i - 1) * thy dx;
-			const double tilt_db = RealTier_getValueAtTime (my spectralTilt.get(), t);
+			const double tilt_db = tilts_db [i];
 
 			if (tilt_db > 0) {
 				const double d = pow (10.0, -tilt_db / 10.0);
@@ -1051,6 +1054,7 @@ static autoSound PhonationGrid_PhonationTier_to_Sound_voiced (PhonationGrid me,
 				Generate the period.
 		*/
 		VEC sound = his z.row (1);
+		RealTierCursor breathinessAmplitude (my breathinessAmplitude.get());
 		for (integer it = 1; it <= thy points.size; it ++) {
 			PhonationPoint point = thy points.at [it];
 			const double t = point -> number;		// the glottis "closing" point
@@ -1094,7 +1098,7 @@ static autoSound PhonationGrid_PhonationTier_to_Sound_voiced (PhonationGrid me,
 					// Breathiness only during open part modulated by the flow
 					if (breathy) {
 						double val = flow * NUMrandomUniform (-1.0, 1.0);
-						double a = RealTier_getValueAtTime (my breathinessAmplitude.get(), t);
+						double a = breathinessAmplitude.getValueAtTime (t);
 						breathy -> z [1] [i] += val * DBSPL_to_A (a);
 					}
 				}
@@ -1137,9 +1141,9 @@ static autoSound PhonationGrid_PhonationTier_to_Sound_voiced (PhonationGrid me,
 			Vector_scale (him.get(), extremum);
 		}
 
+		const autoVEC voicingAmplitudes = RealTier_listValuesAtRegularTimes (my voicingAmplitude.get(), his x1, his dx, his nx);
 		for (integer i = 1; i <= his nx; i ++) {
-			const double t = his x1 + (i - 1) * his dx;
-			his z [1] [i] *= DBSPL_to_A (RealTier_getValueAtTime (my voicingAmplitude.get(), t));
+			his z [1] [i] *= DBSPL_to_A (voicingAmplitudes [i]);
 			if (breathy)
 				his z [1] [i] += breathy -> z [1] [i];
 		}
@@ -1970,12 +1974,12 @@ autoSound FricationGrid_to_Sound (FricationGrid me, double samplingFrequency) {
 		autoSound thee = Sound_createEmptyMono (my xmin, my xmax, samplingFrequency);
 
 		double lastval = 0.0;
+		const autoVEC fricationAmplitudes = RealTier_listValuesAtRegularTimes (my fricationAmplitude.get(), thy x1, thy dx, thy nx);
 		for (integer i = 1; i <= thy nx; i ++) {
-			const double t = thy x1 + (i - 1) * thy dx;
 			double val = NUMrandomUniform (-1.0, 1.0);
 			double a = 0.0;
 			if (my fricationAmplitude -> points.size > 0) {
-				const double dba = RealTier_getValueAtTime (my fricationAmplitude.get(), t);
+				const double dba = fricationAmplitudes [i];
 				a = ( isdefined (dba) ? DBSPL_to_A (dba) : 0.0 );
 			}
 			lastval = (val += 0.75 * lastval); // TODO: soft low-pass coefficient should be Fs dependent!
@@ -2009,11 +2013,11 @@ autoSound Sound_FricationGrid_filter (Sound me, FricationGrid thee) {
 			him = Data_copy (me);
 
 		if (pf -> bypass) {
+			const autoVEC bypassValues = RealTier_listValuesAtRegularTimes (thy bypass.get(), his x1, his dx, his nx);
 			for (integer is = 1; is <= his nx; is ++) {	// Bypass
-				const double t = his x1 + (is - 1) * his dx;
 				double ab = 0.0;
 				if (thy bypass -> points.size > 0) {
-					const double val = RealTier_getValueAtTime (thy bypass.get(), t);
+					const double val = bypassValues [is];
 					ab = ( isundef (val) ? 0.0 : DB_to_A (val) );
 				}
 				his z [1] [is] += my z [1] [is] * ab;
@@ -793,8 +793,9 @@ void SSCP_unExpand (SSCP me) {
 }
 
 void SSCP_expandWithLowerCholeskyInverse (SSCP me) {
-	if (NUMisEmpty (my lowerCholeskyInverse.get()))
-		my lowerCholeskyInverse = raw_MAT (my numberOfColumns, my numberOfColumns);
+	const integer numberOfRowsOfInverse = ( my numberOfRows == 1 ? 1 : my numberOfColumns );   // a diagonal inverse is a single row, as NUMmahalanobisDistanceSquared expects
+	if (my lowerCholeskyInverse.nrow != numberOfRowsOfInverse || my lowerCholeskyInverse.ncol != my numberOfColumns)
+		my lowerCholeskyInverse = raw_MAT (numberOfRowsOfInverse, my numberOfColumns);
 	if (my numberOfRows == 1) {   // diagonal
 		my lnd = 0.0;
 		for (integer j = 1; j <= my numberOfColumns; j ++) {
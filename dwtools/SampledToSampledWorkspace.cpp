@@ -18,8 +18,8 @@
 
 #include "SampledToSampledWorkspace.h"
 #include "Sound_extensions.h"
-#include <thread>
 #include <atomic>
+#include "MelderThread.h"
 #include "NUM2.h"
 
 #include "oo_DESTROY.h"
@@ -97,16 +97,9 @@ void SampledToSampledWorkspace_replaceOutput (mutableSampledToSampledWorkspace m
 
 
 void SampledToSampledWorkspace_getThreadingInfo (constSampledToSampledWorkspace me, integer *out_numberOfThreads) {
-	const integer numberOfProcessors = std::thread::hardware_concurrency ();
-	/*
-		Our processes are compute bound, therefore it probably makes no sense to start more than two threads on one processor
-	*/
-	integer maximumNumberOfThreads = 2 * numberOfProcessors;
+	integer numberOfThreads = MelderThread_computeNumberOfThreads (my output -> nx, my minimumNumberOfFramesPerThread);
 	if (my maximumNumberOfThreads > 0)
-		 maximumNumberOfThreads = std::min (my maximumNumberOfThreads, maximumNumberOfThreads);
-	const integer numberOfFrames = my output -> nx;
-	integer numberOfThreads = 1 + (numberOfFrames - 1) / my minimumNumberOfFramesPerThread;
-	Melder_clip (1_integer, & numberOfThreads, maximumNumberOfThreads);
+		Melder_clipRight (& numberOfThreads, my maximumNumberOfThreads);
 	if (out_numberOfThreads)
 		*out_numberOfThreads = numberOfThreads;
 }
@@ -119,47 +112,27 @@ void SampledToSampledWorkspace_analyseThreaded (mutableSampledToSampledWorkspace
 
 		const integer numberOfFrames = my output -> nx;
 		
-		std::atomic<integer> globalFrameErrorCount (0);
-		
 		if (my useMultiThreading) {
 			integer numberOfThreads;
 			SampledToSampledWorkspace_getThreadingInfo (me, & numberOfThreads);
-			const integer numberOfFramesPerThread = my minimumNumberOfFramesPerThread;
 			/*
 				We have to reserve all the needed working memory for each thread beforehand.
+				The frames are handed out in chunks by the thread pool,
+				so that a thread with many expensive frames does not keep the others waiting.
 			*/
 			OrderedOf<structSampledToSampledWorkspace> workspaces;
 			for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
 				autoSampledToSampledWorkspace threadWorkspace = Data_copy (me);
 				workspaces.addItem_move (threadWorkspace.move());
 			}
-		
-			autovector<std::thread> threads = autovector<std::thread> (numberOfThreads, MelderArray::kInitializationType::ZERO);
-			
-			try {
-				for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			std::atomic<integer> globalFrameErrorCount (0);
+			MelderThread_runChunked (numberOfThreads, numberOfFrames, 0,
+				[&] (integer ithread, integer fromFrame, integer toFrame) {
 					SampledToSampledWorkspace threadWorkspace = workspaces.at [ithread];
-					const integer firstFrame = 1 + (ithread - 1) * numberOfFramesPerThread;
-					const integer lastFrame = ( ithread == numberOfThreads ? numberOfFrames : firstFrame + numberOfFramesPerThread - 1 );
-					
-					auto analyseFrames = [&globalFrameErrorCount] (SampledToSampledWorkspace threadWorkspace, integer fromFrame, integer toFrame) {
-						threadWorkspace -> inputFramesToOutputFrames (fromFrame, toFrame);
-						globalFrameErrorCount += threadWorkspace -> globalFrameErrorCount;
-					};
-
-					threads [ithread] = std::thread (analyseFrames, threadWorkspace, firstFrame, lastFrame);
+					threadWorkspace -> inputFramesToOutputFrames (fromFrame, toFrame);
+					globalFrameErrorCount += threadWorkspace -> globalFrameErrorCount;
 				}
-				
-				for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-					threads [ithread]. join ();
-				
-			} catch (MelderError) {
-				for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-					if (threads [ithread]. joinable ())
-						threads [ithread]. join ();
-				Melder_clearError ();
-				throw;
-			}
+			);
 			my globalFrameErrorCount = globalFrameErrorCount;
 		} else {
 			my inputFramesToOutputFrames (1, numberOfFrames); // no threading
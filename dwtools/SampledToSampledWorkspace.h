@@ -25,7 +25,11 @@
 
 void SampledToSampledWorkspace_init (mutableSampledToSampledWorkspace me, constSampled input, mutableSampled output);
 
-void SampledToSampledWorkspace_getThreadingInfo (constSampledToSampledWorkspace me, integer maximumNumberOfThreads, integer numberOfFramesPerThread, integer *out_numberOfThreads);
+void SampledToSampledWorkspace_getThreadingInfo (constSampledToSampledWorkspace me, integer *out_numberOfThreads);
+/*
+	The threads come from the process-wide pool (see MelderThread.h);
+	my maximumNumberOfThreads (if positive) can only lower the number set there.
+*/
 
 void SampledToSampledWorkspace_replaceOutput (mutableSampledToSampledWorkspace me, mutableSampled thee);
 /*
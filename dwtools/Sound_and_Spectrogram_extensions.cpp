@@ -31,6 +31,8 @@
 #include "Sound_to_Pitch.h"
 #include "Vector.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
 
 autoSound BandFilterSpectrogram_as_Sound (BandFilterSpectrogram me, int to_dB);
 
@@ -57,57 +59,139 @@ static void _Spectrogram_windowCorrection (Spectrogram me, integer numberOfSampl
 	my z.get()  /=  windowFactor;
 }
 
-static autoSpectrum Sound_to_Spectrum_power (Sound me) {
-	try {
-		autoSpectrum thee = Sound_to_Spectrum (me, true);
-		double scale = 2.0 * thy dx / (my xmax - my xmin);
-		/*
-			factor '2' because we combine positive and negative frequencies
-			thy dx : width of frequency bin
-			my xmax - my xmin : duration of sound
-		*/
-		VEC re = thy z.row (1), im = thy z.row (2);
-		for (integer i = 1; i <= thy nx; i ++) {
-			const double power = scale * (re [i] * re [i] + im [i] * im [i]);
-			re [i] = power;
-			im [i] = 0.0;
-		}
-		/*
-			Correction of frequency bins at 0 Hz and nyquist: don't count for two.
-		*/
-		re [1] *= 0.5;
-		re [thy nx] *= 0.5;
-		return thee;
-	} catch (MelderError) {
-		Melder_throw (me, U": no Spectrum with spectral power created.");
+/*
+	A filter bank analysis computes the power spectrum of every windowed frame
+	and sums it with the amplitudes of every filter.
+	Everything that is the same for all frames is computed only once:
+	the Gaussian window, the frequency bins of the spectrum,
+	and, for every filter, the consecutive bins it covers with the filter amplitudes in those bins
+	(a sparse filter-by-bin matrix, stored row after row in `weights`).
+	The power spectrum is the same, to the last bit, as that of the frame
+	copied with Sound_into_Sound (), windowed with Sounds_multiply () and transformed with Sound_to_Spectrum ().
+*/
+Thing_define (BandFilterBank, Thing) { public:
+	autoSound window;
+	autoSpectrum bins;   // the frequency grid of the power spectrum, without data
+	integer numberOfFourierSamples;
+	double powerScaling;
+	autoINTVEC firstBin, firstWeight;   // firstWeight [numberOfFilters + 1] is one beyond the last weight
+	autoVEC weights;
+};
+
+Thing_implement (BandFilterBank, Thing, 0);
+
+static autoBandFilterBank BandFilterBank_create (double windowDuration, double samplingFrequency, integer numberOfFilters,
+	std::function <void (Spectrum bins, integer ifilter, integer *out_firstBin, integer *out_lastBin)> const& getBins,
+	std::function <double (Spectrum bins, integer ifilter, integer ibin)> const& getAmplitude)
+{
+	autoBandFilterBank me = Thing_new (BandFilterBank);
+	my window = Sound_createGaussian (windowDuration, samplingFrequency);
+	my numberOfFourierSamples = Melder_iroundUpToPowerOfTwo (my window -> nx);
+	my bins = Spectrum_create (0.5 / my window -> dx, my numberOfFourierSamples / 2 + 1);
+	my bins -> dx = 1.0 / (my window -> dx * my numberOfFourierSamples);   // as in Sound_to_Spectrum ()
+	my powerScaling = 2.0 * my bins -> dx / (my window -> xmax - my window -> xmin);
+
+	my firstBin = raw_INTVEC (numberOfFilters);
+	my firstWeight = raw_INTVEC (numberOfFilters + 1);
+	integer numberOfWeights = 0;
+	autoINTVEC lastBin = raw_INTVEC (numberOfFilters);
+	for (integer ifilter = 1; ifilter <= numberOfFilters; ifilter ++) {
+		getBins (my bins.get(), ifilter, & my firstBin [ifilter], & lastBin [ifilter]);
+		my firstWeight [ifilter] = numberOfWeights + 1;
+		numberOfWeights += std::max (0_integer, lastBin [ifilter] - my firstBin [ifilter] + 1);
 	}
+	my firstWeight [numberOfFilters + 1] = numberOfWeights + 1;
+	my weights = raw_VEC (numberOfWeights);
+	for (integer ifilter = 1; ifilter <= numberOfFilters; ifilter ++)
+		for (integer ibin = my firstBin [ifilter], iweight = my firstWeight [ifilter]; ibin <= lastBin [ifilter]; ibin ++, iweight ++)
+			my weights [iweight] = getAmplitude (my bins.get(), ifilter, ibin);
+	return me;
 }
 
-static void Sound_into_BarkSpectrogram_frame (Sound me, BarkSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-	integer numberOfFrequencies = his nx;
-
-	autoVEC z = raw_VEC (numberOfFrequencies);
-	for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
-		const double frequency_Hz = his x1 + (ifreq - 1) * his dx;
-		z [ifreq] = thy v_hertzToFrequency (frequency_Hz);
+/*
+	The power spectrum of the windowed frame that starts at `startTime` in the first channel of `sound`,
+	in the workspaces `data` (numberOfFourierSamples) and `power` (the number of bins).
+*/
+static void BandFilterBank_getPowerSpectrum (BandFilterBank me, Sound sound, double startTime,
+	NUMfft_Table fftTable, VEC const& data, VEC const& power)
+{
+	const integer numberOfSamples = my window -> nx, numberOfBins = my bins -> nx;
+	const integer index = Sampled_xToNearestIndex (sound, startTime);
+	const constVEC window = my window -> z.row (1);
+	for (integer i = 1; i <= numberOfSamples; i ++) {
+		const integer j = index - 1 + i;
+		data [i] = ( j < 1 || j > sound -> nx ? 0.0 : sound -> z [1] [j] ) * window [i];
+	}
+	data.part (numberOfSamples + 1, my numberOfFourierSamples)  <<=  0.0;
+	NUMfft_forward (fftTable, data);
+
+	const double scaling = my window -> dx;
+	const double re1 = data [1] * scaling;
+	power [1] = my powerScaling * (re1 * re1);
+	for (integer i = 2; i < numberOfBins; i ++) {
+		const double re = data [i + i - 2] * scaling, im = data [i + i - 1] * scaling;
+		power [i] = my powerScaling * (re * re + im * im);
 	}
+	if (my numberOfFourierSamples > 1) {
+		const double re = data [my numberOfFourierSamples] * scaling;
+		power [numberOfBins] = my powerScaling * (re * re);
+	}
+	/*
+		Correction of frequency bins at 0 Hz and nyquist: don't count for two.
+	*/
+	power [1] *= 0.5;
+	power [numberOfBins] *= 0.5;
+}
 
-	for (integer i = 1; i <= thy ny; i ++) {
-		const double z0 = thy y1 + (i - 1) * thy dy;
-		constVEC pow = his z.row (1); // TODO ??
-		longdouble p = 0.0;
-		for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
-			/*
-				Sekey & Hanson filter is defined in the power domain.
-				We therefore multiply the power with a (and not a^2).
-				integral (F(z),z=0..25) = 1.58/9
-			*/
-			const double a = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
-			p += a * pow [ifreq] ;
-		}
-		thy z [i] [frame] = double (p);
+Thing_define (BandFilterBank_Workspace, Thing) { public:
+	autoNUMfft_Table fftTable;
+	autoVEC data, power;
+};
+
+Thing_implement (BandFilterBank_Workspace, Thing, 0);
+
+/*
+	Fills all the frames of `thee` (a Mel or Bark spectrogram that has the filters of `me`),
+	with one FFT table and frame buffer per thread.
+*/
+static void BandFilterBank_analyse (BandFilterBank me, Sound sound, BandFilterSpectrogram thee, conststring32 analysisName) {
+	const integer numberOfFrames = thy nx, numberOfFilters = thy ny;
+	Melder_assert (my firstBin.size == numberOfFilters);
+	const double windowDuration = my window -> xmax - my window -> xmin;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 20);
+	OrderedOf <structBandFilterBank_Workspace> workspaces;
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		autoBandFilterBank_Workspace workspace = Thing_new (BandFilterBank_Workspace);
+		NUMfft_Table_init (& workspace -> fftTable, my numberOfFourierSamples);
+		workspace -> data = raw_VEC (my numberOfFourierSamples);
+		workspace -> power = raw_VEC (my bins -> nx);
+		workspaces. addItem_move (workspace.move());
 	}
+	std::atomic <integer> numberOfFramesDone (0);
+	MelderThread_runChunked (numberOfThreads, numberOfFrames, 0,
+		[&] (integer ithread, integer fromFrame, integer toFrame) {
+			BandFilterBank_Workspace workspace = workspaces.at [ithread];
+			const constVEC power = workspace -> power.get();
+			for (integer iframe = fromFrame; iframe <= toFrame; iframe ++) {
+				if (ithread == 1)   // only the calling thread may talk to the user
+					Melder_progress (numberOfFramesDone / (numberOfFrames + 1.0),
+						analysisName, U": frame ", numberOfFramesDone + 1, U" out of ", numberOfFrames, U".");
+				const double t = Sampled_indexToX (thee, iframe);
+				BandFilterBank_getPowerSpectrum (me, sound, t - windowDuration / 2.0,
+						& workspace -> fftTable, workspace -> data.get(), workspace -> power.get());
+				for (integer ifilter = 1; ifilter <= numberOfFilters; ifilter ++) {
+					const integer firstBin = my firstBin [ifilter];
+					const integer firstWeight = my firstWeight [ifilter], lastWeight = my firstWeight [ifilter + 1] - 1;
+					longdouble sum = 0.0;
+					for (integer iweight = firstWeight, ibin = firstBin; iweight <= lastWeight; iweight ++, ibin ++)
+						sum += my weights [iweight] * power [ibin];
+					thy z [ifilter] [iframe] = double (sum);
+				}
+				++ numberOfFramesDone;
+			}
+		}
+	);
+	_Spectrogram_windowCorrection ((Spectrogram) thee, my window -> nx);
 }
 
 autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, double dt, double f1_bark, double fmax_bark, double df_bark) {
@@ -134,55 +218,34 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoBarkSpectrogram thee = BarkSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_bark, fmax_bark, numberOfFilters, df_bark, f1_bark);
 
-		autoMelderProgress progess (U"BarkSpectrogram analysis");
-
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_BarkSpectrogram_frame (sframe.get(), thee.get(), iframe);
-
-			if (iframe % 10 == 1)
-				Melder_progress ( (double) iframe / numberOfFrames,  U"BarkSpectrogram analysis: frame ",
-					iframe, U" from ", numberOfFrames, U".");
-		}
-		
-		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
+		/*
+			The Sekey & Hanson filter is defined in the power domain,
+			so we multiply the power with the amplitude a (and not with a^2);
+			integral (F(z),z=0..25) = 1.58/9.
+			The filter is nowhere zero, so every filter covers all the bins.
+		*/
+		autoBandFilterBank filterBank = BandFilterBank_create (windowDuration, samplingFrequency, numberOfFilters,
+			[] (Spectrum bins, integer /* ifilter */, integer *out_firstBin, integer *out_lastBin) {
+				*out_firstBin = 1;
+				*out_lastBin = bins -> nx;
+			},
+			[&] (Spectrum bins, integer ifilter, integer ibin) {
+				const double z0 = thy y1 + (ifilter - 1) * thy dy;
+				const double frequency_Hz = bins -> x1 + (ibin - 1) * bins -> dx;
+				return NUMsekeyhansonfilter_amplitude (z0, thy v_hertzToFrequency (frequency_Hz));
+			}
+		);
 
+		autoMelderProgress progess (U"BarkSpectrogram analysis");
+		BandFilterBank_analyse (filterBank.get(), me, thee.get(), U"BarkSpectrogram analysis");
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": no BarkSpectrogram created.");
 	}
 }
 
-static void Sound_into_MelSpectrogram_frame (Sound me, MelSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-
-	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
-		longdouble power = 0.0;
-		const double fc_mel = thy y1 + (ifilter - 1) * thy dy;
-		const double fc_hz = thy v_frequencyToHertz (fc_mel);
-		const double fl_hz = thy v_frequencyToHertz (std::max (fc_mel - thy dy, 0.0));
-		const double fh_hz =  thy v_frequencyToHertz (std::min (fc_mel + thy dy, his xmax));
-		integer ifrom, ito;
-		Sampled_getWindowSamples (him.get(), fl_hz, fh_hz, & ifrom, & ito);
-		for (integer i = ifrom; i <= ito; i ++) {
-			/*
-				Bin with a triangular filter the power (= amplitude-squared)
-			*/
-			const double f = his x1 + (i - 1) * his dx;
-			const double a = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
-			power += a * his z [1] [i];
-		}
-		thy z [ifilter] [frame] = double (power);
-	}
-}
-
 autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
 	try {
 		const double samplingFrequency = 1.0 / my dx, nyquist = 0.5 * samplingFrequency;
@@ -211,24 +274,28 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoMelSpectrogram thee = MelSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_mel, fmax_mel, numberOfFilters, df_mel, f1_mel);
 
-		autoMelderProgress progress (U"MelSpectrogram analysis");
-
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_MelSpectrogram_frame (sframe.get(), thee.get(), iframe);
-			
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ", numberOfFrames, U".");
-		}
-		
-		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
+		/*
+			Bin the power (= amplitude-squared) with triangular filters.
+		*/
+		autoVEC fl_hz = raw_VEC (numberOfFilters), fc_hz = raw_VEC (numberOfFilters), fh_hz = raw_VEC (numberOfFilters);
+		autoBandFilterBank filterBank = BandFilterBank_create (windowDuration, samplingFrequency, numberOfFilters,
+			[&] (Spectrum bins, integer ifilter, integer *out_firstBin, integer *out_lastBin) {
+				const double fc_mel = thy y1 + (ifilter - 1) * thy dy;
+				fc_hz [ifilter] = thy v_frequencyToHertz (fc_mel);
+				fl_hz [ifilter] = thy v_frequencyToHertz (std::max (fc_mel - thy dy, 0.0));
+				fh_hz [ifilter] =  thy v_frequencyToHertz (std::min (fc_mel + thy dy, bins -> xmax));
+				Sampled_getWindowSamples (bins, fl_hz [ifilter], fh_hz [ifilter], out_firstBin, out_lastBin);
+			},
+			[&] (Spectrum bins, integer ifilter, integer ibin) {
+				const double f = bins -> x1 + (ibin - 1) * bins -> dx;
+				return NUMtriangularfilter_amplitude (fl_hz [ifilter], fc_hz [ifilter], fh_hz [ifilter], f);
+			}
+		);
 
+		autoMelderProgress progress (U"MelSpectrogram analysis");
+		BandFilterBank_analyse (filterBank.get(), me, thee.get(), U"MelSpectrogram analysis");
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": No MelSpectrogram created.");
@@ -239,28 +306,24 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 	Analog formant filter response :
 	H(f) = i f B / (f1^2 - f^2 + i f B)
 */
-static int Sound_into_Spectrogram_frame (Sound me, Spectrogram thee, integer frame, double bw) {
+static void Sound_into_Spectrogram_frame (constVEC const& power, Spectrum bins, Spectrogram thee, integer frame, double bw) {
 	Melder_assert (bw > 0.0);
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-
 	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
 		const double fc = thy y1 + (ifilter - 1) * thy dy;
-		constVEC pow = his z.row (1);
 		double p = 0.0;
-		for (integer ifreq = 1; ifreq <= his nx; ifreq ++) {
+		for (integer ifreq = 1; ifreq <= bins -> nx; ifreq ++) {
 			/*
 				H(f) = ifB / (fc^2 - f^2 + ifB)
 				H(f)| = fB / sqrt ((fc^2 - f^2)^2 + f^2B^2)
 				|H(f)|^2 = f^2B^2 / ((fc^2 - f^2)^2 + f^2B^2)
 						 = 1 / (((fc^2 - f^2) /fB)^2 + 1)
 			*/
-			const double f = his x1 + (ifreq - 1) * his dx;
+			const double f = bins -> x1 + (ifreq - 1) * bins -> dx;
 			const double a = NUMformantfilter_amplitude (fc, bw, f);
-			p += a * pow [ifreq];
+			p += a * power [ifreq];
 		}
 		thy z [ifilter] [frame] = p;
 	}
-	return 1;
 }
 
 autoSpectrogram Sound_to_Spectrogram_pitchDependent (Sound me, double analysisWidth, double dt, double f1_hz, double fmax_hz, double df_hz, double relative_bw,
@@ -306,10 +369,13 @@ autoSpectrogram Sound_Pitch_to_Spectrogram (Sound me, Pitch thee, double analysi
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
 		autoSpectrogram him = Spectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_hz, fmax_hz, numberOfFilters, df_hz, f1_hz);
 
-		// Temporary objects
-
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
+		/*
+			The filters depend on the pitch, so the filter bank is used only for the power spectrum.
+		*/
+		autoBandFilterBank filterBank = BandFilterBank_create (windowDuration, samplingFrequency, 0, nullptr, nullptr);
+		autoNUMfft_Table fftTable;
+		NUMfft_Table_init (& fftTable, filterBank -> numberOfFourierSamples);
+		autoVEC data = raw_VEC (filterBank -> numberOfFourierSamples), power = raw_VEC (filterBank -> bins -> nx);
 		autoMelderProgress progress (U"Sound & Pitch: To FormantFilter");
 		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
 			const double t = Sampled_indexToX (him.get(), iframe);
@@ -320,17 +386,15 @@ autoSpectrogram Sound_Pitch_to_Spectrogram (Sound me, Pitch thee, double analysi
 				f0 = f0_median;
 			}
 			const double b = relative_bw * f0;
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-
-			Sound_into_Spectrogram_frame (sframe.get(), him.get(), iframe, b);
+			BandFilterBank_getPowerSpectrum (filterBank.get(), me, t - windowDuration / 2.0, & fftTable, data.get(), power.get());
+			Sound_into_Spectrogram_frame (power.get(), filterBank -> bins.get(), him.get(), iframe, b);
 
 			if (iframe % 10 == 1)
 				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ",
 					numberOfFrames, U".");
 		}
 		
-		_Spectrogram_windowCorrection (him.get(), window -> nx);
+		_Spectrogram_windowCorrection (him.get(), filterBank -> window -> nx);
 
 		return him;
 	} catch (MelderError) {
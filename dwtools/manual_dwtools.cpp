@@ -1940,6 +1940,26 @@ DEFINITION (U"determines the maximum and minimum local slopes in the optimal pat
 NORMAL (U"For more information see the article of @@Sakoe & Chiba (1978)@.")
 MAN_END
 
+MAN_BEGIN (U"Matrices: To RealTier (time warp)...", U"djmw", 20261018)
+INTRO (U"A command to align two selected @Matrix objects whose columns are feature vectors, "
+	"such as cepstral coefficients, without creating a @DTW.")
+NORMAL (U"The result is a @RealTier that gives, for every time in the first Matrix, the corresponding time in the second Matrix. "
+	"The path is the same as the one that ##To DTW...# followed by @@DTW: Find path (band & slope)...@ would find, "
+	"but the distances between the columns are computed only inside the band, "
+	"so that the memory and time needed are proportional to the area of the band instead of to the product of the numbers of columns. "
+	"This makes it possible to align recordings of many minutes.")
+ENTRY (U"Settings")
+TERM (U"##Distance metric#")
+DEFINITION (U"the power %p in the distance (\\Si|%x__%k_ \\-- %y__%k_|^%p)^^1/%p^. "
+	"The values 1 (city block) and 2 (Euclidean) are computed fastest.")
+TERM (U"##Sakoe-Chiba band (s)#, ##Slope constraint#")
+DEFINITION (U"as in @@DTW: Find path (band & slope)...@.")
+TERM (U"##Multiscale radius (frames)#")
+DEFINITION (U"if positive, the path is first determined at half the time resolution (and so on, recursively), "
+	"and at each finer resolution only the cells within this number of frames from the coarse path are considered. "
+	"This is much faster for long recordings, but is not guaranteed to find the optimal path.")
+MAN_END
+
 MAN_BEGIN (U"DTW: Get maximum consecutive steps...", U"djmw", 20050307)
 INTRO (U"Get the maximum number of consecutive steps in the chosen direction along the optimal path from the selected @DTW.")
 MAN_END
@@ -3845,6 +3845,24 @@ DO
 	CONVERT_TWO_TO_ONE_END (my name.get(), U"_", your name.get())
 }
 
+FORM (CONVERT_TWO_TO_ONE__Matrices_to_RealTier_timeWarp, U"Matrices: To RealTier (time warp)", U"Matrices: To RealTier (time warp)...") {
+	REAL (distanceMetric, U"Distance metric", U"2.0")
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.05")
+	CHOICE (slopeConstraint, U"Slope constraint", 1)
+		OPTION (U"no restriction")
+		OPTION (U"1/3 < slope < 3")
+		OPTION (U"1/2 < slope < 2")
+		OPTION (U"2/3 < slope < 3/2")
+	INTEGER (multiscaleRadius, U"Multiscale radius (frames)", U"0 (= no multiscale search)")
+	OK
+DO
+	Melder_require (multiscaleRadius >= 0,
+		U"The multiscale radius should not be negative.");
+	CONVERT_TWO_TO_ONE (Matrix)
+		autoRealTier result = Matrices_to_RealTier_timeWarp (me, you, sakoeChibaBand, slopeConstraint, distanceMetric, multiscaleRadius);
+	CONVERT_TWO_TO_ONE_END (my name.get(), U"_", your name.get())
+}
+
 FORM (CONVERT_EACH_TO_ONE__Matrix_to_PatternList, U"Matrix: To PatternList", nullptr) {
 	NATURAL (join, U"Join", U"1")
 	OK
@@ -6167,6 +6185,23 @@ DO
 	CONVERT_TWO_TO_ONE_END (my name.get(), U"_", your name.get())
 }
 
+FORM (CONVERT_TWO_TO_ONE__Spectrograms_to_RealTier_timeWarp, U"Spectrograms: To RealTier (time warp)", nullptr) {
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.05")
+	CHOICE (slopeConstraint, U"Slope constraint", 1)
+		OPTION (U"no restriction")
+		OPTION (U"1/3 < slope < 3")
+		OPTION (U"1/2 < slope < 2")
+		OPTION (U"2/3 < slope < 3/2")
+	INTEGER (multiscaleRadius, U"Multiscale radius (frames)", U"0 (= no multiscale search)")
+	OK
+DO
+	Melder_require (multiscaleRadius >= 0,
+		U"The multiscale radius should not be negative.");
+	CONVERT_TWO_TO_ONE (Spectrogram)
+		autoRealTier result = Spectrograms_to_RealTier_timeWarp (me, you, sakoeChibaBand, slopeConstraint, multiscaleRadius);
+	CONVERT_TWO_TO_ONE_END (my name.get(), U"_", your name.get())
+}
+
 FORM (GRAPHICS_EACH__Spectrogram_drawLongtermSpectralFlatness, U"Spectrogram: Draw long-term spectral flatness", U"") {
 //double tmin, double tmax, double minimumFlatness_db,
 //	double longtermWindow, double shorttermWindow, double fmin, double fmax, bool garnish
@@ -9864,6 +9899,8 @@ void praat_David_init () {
 			CONVERT_EACH_TO_MULTIPLE_Matrix_eigen_complex);
 	praat_addAction1 (classMatrix, 2, U"To DTW...", U"To ParamCurve", 1, 
 			CONVERT_TWO_TO_ONE__Matrices_to_DTW);
+	praat_addAction1 (classMatrix, 2, U"To RealTier (time warp)...", U"To DTW...", 1, 
+			CONVERT_TWO_TO_ONE__Matrices_to_RealTier_timeWarp);
 
 	praat_addAction2 (classMatrix, 1, classCategories, 1, U"To TableOfReal", nullptr, 0, 
 			CONVERT_ONE_AND_ONE_TO_ONE__Matrix_Categories_to_TableOfReal);
@@ -10291,6 +10328,8 @@ void praat_David_init () {
 
 	praat_addAction1 (classSpectrogram, 2, U"To DTW...", U"To Spectrum (slice)...", 1, 
 			CONVERT_TWO_TO_ONE__Spectrograms_to_DTW);
+	praat_addAction1 (classSpectrogram, 2, U"To RealTier (time warp)...", U"To DTW...", 1, 
+			CONVERT_TWO_TO_ONE__Spectrograms_to_RealTier_timeWarp);
 	praat_addAction1 (classSpectrogram, 0, U"Draw long-term spectral flatness...", U"Paint...", GuiMenu_HIDDEN | GuiMenu_DEPTH_1,
 			GRAPHICS_EACH__Spectrogram_drawLongtermSpectralFlatness);
 	praat_addAction1 (classSpectrogram, 0, U"Get long-term spectral flatness...", U"To DTW...", GuiMenu_HIDDEN | GuiMenu_DEPTH_1,
@@ -723,7 +723,7 @@ L60:
 
 } /* dgbmv_ */
 
-/* Subroutine */ int dgemm_(const char *transa, const char *transb, integer *m, integer *
+/* Subroutine */ int dgemm_reference_(const char *transa, const char *transb, integer *m, integer *
 	n, integer *k, double *alpha, double *a, integer *lda,
 	double *b, integer *ldb, double *beta, double *c__,
 	integer *ldc)
@@ -1091,7 +1091,7 @@ L60:
 
 /*     End of DGEMM . */
 
-} /* dgemm_ */
+} /* dgemm_reference_ */
 
 /* Subroutine */ int dgemv_(const char *trans, integer *m, integer *n, double *
 	alpha, double *a, integer *lda, double *x, integer *incx,
@@ -4814,7 +4814,7 @@ L40:
 
 } /* dsyr2_ */
 
-/* Subroutine */ int dsyr2k_(const char *uplo, const char *trans, integer *n, integer *k,
+/* Subroutine */ int dsyr2k_reference_(const char *uplo, const char *trans, integer *n, integer *k,
 	double *alpha, double *a, integer *lda, double *b,
 	integer *ldb, double *beta, double *c__, integer *ldc)
 {
@@ -5205,9 +5205,9 @@ L40:
 
 /*     End of DSYR2K. */
 
-} /* dsyr2k_ */
+} /* dsyr2k_reference_ */
 
-/* Subroutine */ int dsyrk_(const char *uplo, const char *trans, integer *n, integer *k,
+/* Subroutine */ int dsyrk_reference_(const char *uplo, const char *trans, integer *n, integer *k,
 	double *alpha, double *a, integer *lda, double *beta,
 	double *c__, integer *ldc)
 {
@@ -5563,7 +5563,7 @@ L40:
 
 /*     End of DSYRK . */
 
-} /* dsyrk_ */
+} /* dsyrk_reference_ */
 
 /* Subroutine */ int dtbmv_(const char *uplo, const char *trans, const char *diag, integer *n,
 	integer *k, double *a, integer *lda, double *x, integer *incx)
@@ -7844,7 +7844,7 @@ L40:
 
 } /* dtrmv_ */
 
-/* Subroutine */ int dtrsm_(const char *side, const char *uplo, const char *transa, const char *diag,
+/* Subroutine */ int dtrsm_reference_(const char *side, const char *uplo, const char *transa, const char *diag,
 	integer *m, integer *n, double *alpha, double *a, integer *
 	lda, double *b, integer *ldb)
 {
@@ -8318,7 +8318,7 @@ L40:
 
 /*     End of DTRSM . */
 
-} /* dtrsm_ */
+} /* dtrsm_reference_ */
 
 /* Subroutine */ int dtrsv_(const char *uplo, const char *trans, const char *diag, integer *n,
 	double *a, integer *lda, double *x, integer *incx)
@@ -0,0 +1,215 @@
+/* blas3.cpp
+ *
+ * Copyright (C) 2026 agent
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+	Blocked versions of the level-3 BLAS routines that dominate the LAPACK drivers:
+	dgemm (everywhere), dsyrk (Cholesky), dsyr2k (symmetric tridiagonalization, hence Eigen)
+	and dtrsm (triangular solves).
+
+	Large problems are cut into blocks whose off-diagonal parts are general matrix products,
+	which go to _mul_blocked_MAT_inout in melder/MAT.cpp (packed, register-blocked, multi-threaded);
+	only the small diagonal blocks are handled by the reference routines in blas.cpp.
+	Small problems, and calls with invalid arguments (so that xerbla reports them as before),
+	go to the reference routines directly.
+
+	The matrices are column-major, as in Fortran; we describe them with matrix views
+	whose row stride is 1 and whose column stride is the leading dimension.
+
+	Compile with -DNO_BLOCKED_BLAS to use the reference routines throughout.
+*/
+
+#include "cblas.h"
+#include "f2cP.h"
+
+#ifndef NO_BLOCKED_BLAS
+
+/*
+	The width of the diagonal blocks that go to the reference routines.
+*/
+constexpr integer blas3_BLOCK_SIZE = 128;
+
+static bool blas3_gemmIsWorthwhile (integer const m, integer const n, integer const k) {
+	return m >= 16 && n >= 16 && k >= 16 && double (m) * double (n) * double (k) >= 2e6;
+}
+
+static constMATVU blas3_view (const double *a, integer const nrow, integer const ncol, integer const lda) {
+	return constMATVU (a, nrow, ncol, 1, lda);
+}
+
+static MATVU blas3_view (double *a, integer const nrow, integer const ncol, integer const lda) {
+	return MATVU (a, nrow, ncol, 1, lda);
+}
+
+/*
+	op(A), i.e. A or A', as a view.
+*/
+static constMATVU blas3_op (const char *trans, const double *a, integer const nrow, integer const ncol, integer const lda) {
+	return lsame_ (trans, "N") ? blas3_view (a, nrow, ncol, lda) : blas3_view (a, ncol, nrow, lda).transpose();
+}
+
+static bool blas3_isTrans (const char *trans) {
+	return lsame_ (trans, "T") || lsame_ (trans, "C");
+}
+
+int dgemm_ (const char *transa, const char *transb, integer *m, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *b, integer *ldb, double *beta, double *c__, integer *ldc)
+{
+	const bool nota = lsame_ (transa, "N"), notb = lsame_ (transb, "N");
+	const bool argumentsAreValid = (nota || blas3_isTrans (transa)) && (notb || blas3_isTrans (transb)) &&
+		*lda >= std::max (1_integer, nota ? *m : *k) && *ldb >= std::max (1_integer, notb ? *k : *n) && *ldc >= std::max (1_integer, *m);
+	if (! argumentsAreValid || ! blas3_gemmIsWorthwhile (*m, *n, *k) || *alpha == 0.0)
+		return dgemm_reference_ (transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c__, ldc);
+	_mul_blocked_MAT_inout (blas3_view (c__, *m, *n, *ldc), *alpha,
+		blas3_op (transa, a, *m, *k, *lda), blas3_op (transb, b, *k, *n, *ldb), *beta);
+	return 0;
+}
+
+int dsyrk_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *beta, double *c__, integer *ldc)
+{
+	const bool upper = lsame_ (uplo, "U"), nota = lsame_ (trans, "N");
+	const bool argumentsAreValid = (upper || lsame_ (uplo, "L")) && (nota || blas3_isTrans (trans)) &&
+		*lda >= std::max (1_integer, nota ? *n : *k) && *ldc >= std::max (1_integer, *n);
+	if (! argumentsAreValid || *n <= blas3_BLOCK_SIZE || ! blas3_gemmIsWorthwhile (*n, *n, *k) || *alpha == 0.0)
+		return dsyrk_reference_ (uplo, trans, n, k, alpha, a, lda, beta, c__, ldc);
+	/*
+		C := alpha op(A) op(A)' + beta C, with op(A) an n x k matrix,
+		one block column of the triangle at a time.
+	*/
+	const constMATVU opA = blas3_op (trans, a, *n, *k, *lda);
+	const MATVU c = blas3_view (c__, *n, *n, *ldc);
+	for (integer first = 1; first <= *n; first += blas3_BLOCK_SIZE) {
+		const integer last = std::min (*n, first + blas3_BLOCK_SIZE - 1);
+		integer blockSize = last - first + 1;
+		double *firstRowOfOpA = ( nota ? & a [first - 1] : & a [(first - 1) * *lda] );
+		dsyrk_reference_ (uplo, trans, & blockSize, k, alpha, firstRowOfOpA, lda, beta, & c [first] [first], ldc);
+		if (upper && first > 1)
+			_mul_blocked_MAT_inout (c.part (1, first - 1, first, last), *alpha,
+				opA.part (1, first - 1, 1, *k), opA.part (first, last, 1, *k).transpose(), *beta);
+		else if (! upper && last < *n)
+			_mul_blocked_MAT_inout (c.part (last + 1, *n, first, last), *alpha,
+				opA.part (last + 1, *n, 1, *k), opA.part (first, last, 1, *k).transpose(), *beta);
+	}
+	return 0;
+}
+
+int dsyr2k_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *b, integer *ldb, double *beta, double *c__, integer *ldc)
+{
+	const bool upper = lsame_ (uplo, "U"), nota = lsame_ (trans, "N");
+	const bool argumentsAreValid = (upper || lsame_ (uplo, "L")) && (nota || blas3_isTrans (trans)) &&
+		*lda >= std::max (1_integer, nota ? *n : *k) && *ldb >= std::max (1_integer, nota ? *n : *k) &&
+		*ldc >= std::max (1_integer, *n);
+	if (! argumentsAreValid || *n <= blas3_BLOCK_SIZE || ! blas3_gemmIsWorthwhile (*n, *n, *k) || *alpha == 0.0)
+		return dsyr2k_reference_ (uplo, trans, n, k, alpha, a, lda, b, ldb, beta, c__, ldc);
+	/*
+		C := alpha op(A) op(B)' + alpha op(B) op(A)' + beta C, with op(A) and op(B) n x k matrices.
+	*/
+	const constMATVU opA = blas3_op (trans, a, *n, *k, *lda), opB = blas3_op (trans, b, *n, *k, *ldb);
+	const MATVU c = blas3_view (c__, *n, *n, *ldc);
+	for (integer first = 1; first <= *n; first += blas3_BLOCK_SIZE) {
+		const integer last = std::min (*n, first + blas3_BLOCK_SIZE - 1);
+		integer blockSize = last - first + 1;
+		double *firstRowOfOpA = ( nota ? & a [first - 1] : & a [(first - 1) * *lda] );
+		double *firstRowOfOpB = ( nota ? & b [first - 1] : & b [(first - 1) * *ldb] );
+		dsyr2k_reference_ (uplo, trans, & blockSize, k, alpha, firstRowOfOpA, lda, firstRowOfOpB, ldb, beta, & c [first] [first], ldc);
+		const integer fromRow = ( upper ? 1 : last + 1 ), toRow = ( upper ? first - 1 : *n );
+		if (fromRow <= toRow) {
+			const MATVU offDiagonal = c.part (fromRow, toRow, first, last);
+			_mul_blocked_MAT_inout (offDiagonal, *alpha,
+				opA.part (fromRow, toRow, 1, *k), opB.part (first, last, 1, *k).transpose(), *beta);
+			_mul_blocked_MAT_inout (offDiagonal, *alpha,
+				opB.part (fromRow, toRow, 1, *k), opA.part (first, last, 1, *k).transpose(), 1.0);
+		}
+	}
+	return 0;
+}
+
+int dtrsm_ (const char *side, const char *uplo, const char *transa, const char *diag,
+	integer *m, integer *n, double *alpha, double *a, integer *lda, double *b, integer *ldb)
+{
+	const bool lside = lsame_ (side, "L"), upper = lsame_ (uplo, "U"), nota = lsame_ (transa, "N");
+	const integer nrowa = ( lside ? *m : *n ), ncolb = ( lside ? *n : *m );
+	const bool argumentsAreValid = (lside || lsame_ (side, "R")) && (upper || lsame_ (uplo, "L")) &&
+		(nota || blas3_isTrans (transa)) && (lsame_ (diag, "U") || lsame_ (diag, "N")) &&
+		*lda >= std::max (1_integer, nrowa) && *ldb >= std::max (1_integer, *m);
+	if (! argumentsAreValid || nrowa <= blas3_BLOCK_SIZE || ! blas3_gemmIsWorthwhile (nrowa, ncolb, nrowa / 2) || *alpha == 0.0)
+		return dtrsm_reference_ (side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb);
+	/*
+		Solve op(A) X = alpha B (left side) or X op(A) = alpha B (right side) for X, which overwrites B,
+		one diagonal block of op(A) at a time, from the top left if op(A) is lower triangular on the left side
+		or upper triangular on the right side, and from the bottom right otherwise.
+		After each diagonal block, the rest of B is updated with the part of X just found.
+	*/
+	const constMATVU opA = blas3_op (transa, a, nrowa, nrowa, *lda);
+	const MATVU bmat = blas3_view (b, *m, *n, *ldb);
+	if (*alpha != 1.0)
+		bmat  *=  *alpha;
+	double one = 1.0;
+	const bool forward = ( lside ? upper == ! nota : upper == nota );
+	const integer numberOfBlocks = 1 + (nrowa - 1) / blas3_BLOCK_SIZE;
+	for (integer iblock = 1; iblock <= numberOfBlocks; iblock ++) {
+		const integer jblock = ( forward ? iblock : numberOfBlocks - iblock + 1 );
+		const integer first = 1 + (jblock - 1) * blas3_BLOCK_SIZE;
+		const integer last = std::min (nrowa, first + blas3_BLOCK_SIZE - 1);
+		integer blockSize = last - first + 1;
+		const integer fromRest = ( forward ? last + 1 : 1 ), toRest = ( forward ? nrowa : first - 1 );
+		if (lside) {
+			dtrsm_reference_ (side, uplo, transa, diag, & blockSize, n, & one, & a [(first - 1) + (first - 1) * *lda], lda, & b [first - 1], ldb);
+			if (fromRest <= toRest)
+				_mul_blocked_MAT_inout (bmat.part (fromRest, toRest, 1, *n), -1.0,
+					opA.part (fromRest, toRest, first, last), bmat.part (first, last, 1, *n), 1.0);
+		} else {
+			dtrsm_reference_ (side, uplo, transa, diag, m, & blockSize, & one, & a [(first - 1) + (first - 1) * *lda], lda, & b [(first - 1) * *ldb], ldb);
+			if (fromRest <= toRest)
+				_mul_blocked_MAT_inout (bmat.part (1, *m, fromRest, toRest), -1.0,
+					bmat.part (1, *m, first, last), opA.part (first, last, fromRest, toRest), 1.0);
+		}
+	}
+	return 0;
+}
+
+#else
+
+int dgemm_ (const char *transa, const char *transb, integer *m, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *b, integer *ldb, double *beta, double *c__, integer *ldc)
+{
+	return dgemm_reference_ (transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c__, ldc);
+}
+
+int dsyrk_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *beta, double *c__, integer *ldc)
+{
+	return dsyrk_reference_ (uplo, trans, n, k, alpha, a, lda, beta, c__, ldc);
+}
+
+int dsyr2k_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *b, integer *ldb, double *beta, double *c__, integer *ldc)
+{
+	return dsyr2k_reference_ (uplo, trans, n, k, alpha, a, lda, b, ldb, beta, c__, ldc);
+}
+
+int dtrsm_ (const char *side, const char *uplo, const char *transa, const char *diag,
+	integer *m, integer *n, double *alpha, double *a, integer *lda, double *b, integer *ldb)
+{
+	return dtrsm_reference_ (side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb);
+}
+
+#endif
+
+/* End of file blas3.cpp */
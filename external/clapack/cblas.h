@@ -137,4 +137,26 @@ int dtrsv_ (const char *uplo, const char *trans, const char *diag, integer *n,
 
 integer idamax_ (integer *n, double *dx, integer *incx);
 
+/*
+	The level-3 routines dgemm_, dsyrk_, dsyr2k_ and dtrsm_ (in blas3.cpp) are blocked and multi-threaded
+	for large matrices; the f2c translations of the reference routines (in blas.cpp) remain available
+	under the following names, for small matrices and for testing.
+*/
+int dgemm_reference_ (const char *transa, const char *transb, integer *m, integer *
+	n, integer *k, double *alpha, double *a, integer *lda,
+	double *b, integer *ldb, double *beta, double *c__,
+	integer *ldc);
+
+int dsyrk_reference_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *beta,
+	double *c__, integer *ldc);
+
+int dsyr2k_reference_ (const char *uplo, const char *trans, integer *n, integer *k,
+	double *alpha, double *a, integer *lda, double *b,
+	integer *ldb, double *beta, double *c__, integer *ldc);
+
+int dtrsm_reference_ (const char *side, const char *uplo, const char *transa, const char *diag,
+	integer *m, integer *n, double *alpha, double *a, integer *
+	lda, double *b, integer *ldb);
+
 #endif /* _cblas_h_  */
@@ -91,9 +91,9 @@ autoTableOfReal AmplitudeTier_downto_TableOfReal (AmplitudeTier me) {
 
 void Sound_AmplitudeTier_multiply_inplace (Sound me, AmplitudeTier amplitude) {
 	if (amplitude -> points.size == 0) return;
+	const autoVEC amplitudes = RealTier_listValuesAtRegularTimes (amplitude, my x1, my dx, my nx);
 	for (integer isamp = 1; isamp <= my nx; isamp ++) {
-		double t = my x1 + (isamp - 1) * my dx;
-		double factor = RealTier_getValueAtTime (amplitude, t);
+		double factor = amplitudes [isamp];
 		for (integer channel = 1; channel <= my ny; channel ++) {
 			my z [channel] [isamp] *= factor;
 		}
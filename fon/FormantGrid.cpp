@@ -162,14 +162,15 @@ void Sound_FormantGrid_filter_inplace (Sound me, FormantGrid formantGrid) {
 		for (integer iformant = 1; iformant <= formantGrid -> formants.size; iformant ++) {
 			RealTier formantTier = formantGrid -> formants.at [iformant];
 			RealTier bandwidthTier = formantGrid -> bandwidths.at [iformant];
+			autoVEC formants = RealTier_listValuesAtRegularTimes (formantTier, my x1, my dx, my nx);
+			autoVEC bandwidths = RealTier_listValuesAtRegularTimes (bandwidthTier, my x1, my dx, my nx);
 			for (integer isamp = 1; isamp <= my nx; isamp ++) {
-				double t = my x1 + (isamp - 1) * my dx;
 				/*
 				 * Compute LP coefficients.
 				 */
 				double formant, bandwidth;
-				formant = RealTier_getValueAtTime (formantTier, t);
-				bandwidth = RealTier_getValueAtTime (bandwidthTier, t);
+				formant = formants [isamp];
+				bandwidth = bandwidths [isamp];
 				if (isdefined (formant) && isdefined (bandwidth)) {
 					double cosomdt = cos (2 * NUMpi * formant * dt);
 					double r = exp (- NUMpi * bandwidth * dt);
@@ -101,9 +101,9 @@ autoTableOfReal IntensityTier_downto_TableOfReal (IntensityTier me) {
 void Sound_IntensityTier_multiply_inplace (Sound me, IntensityTier intensity) {
 	if (intensity -> points.size == 0)
 		return;
+	const autoVEC intensities = RealTier_listValuesAtRegularTimes (intensity, my x1, my dx, my nx);
 	for (integer isamp = 1; isamp <= my nx; isamp ++) {
-		const double t = my x1 + (isamp - 1) * my dx;
-		const double factor = pow (10.0, RealTier_getValueAtTime (intensity, t) / 20.0);
+		const double factor = pow (10.0, intensities [isamp] / 20.0);
 		for (integer channel = 1; channel <= my ny; channel ++)
 			my z [channel] [isamp] *= factor;
 	}
@@ -368,6 +368,41 @@ autoSound LongSound_extractPart (LongSound me, double tmin, double tmax, const b
 	}
 }
 
+autoSound LongSound_extractSamples (LongSound me, integer firstSample, integer lastSample) {
+	try {
+		Melder_clipLeft (1_integer, & firstSample);
+		Melder_clipRight (& lastSample, my nx);
+		const integer numberOfSamples = lastSample - firstSample + 1;
+		Melder_require (numberOfSamples >= 1,
+			U"Less than 1 sample in window.");
+		const double x1 = Sampled_indexToX (me, firstSample);
+		autoSound thee = Sound_create (my numberOfChannels, x1 - 0.5 * my dx, x1 + (numberOfSamples - 0.5) * my dx,
+				numberOfSamples, my dx, x1);
+		LongSound_readAudioToFloat (me, thy z.get(), firstSample);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": samples not read.");
+	}
+}
+
+void LongSound_analyseInBlocks (LongSound me, constSampled frames, const double margin,
+	std::function <void (Sound block, integer fromFrame, integer toFrame)> const& analyseBlock)
+{
+	constexpr double blockDuration = 60.0;   // seconds; with 2 channels at 48 kHz, this is 23 MB per block
+	const integer numberOfFramesPerBlock = std::max (1_integer, Melder_ifloor (blockDuration / frames -> dx));
+	const integer numberOfBlocks = 1 + (frames -> nx - 1) / numberOfFramesPerBlock;
+	for (integer iblock = 1; iblock <= numberOfBlocks; iblock ++) {
+		const integer fromFrame = 1 + (iblock - 1) * numberOfFramesPerBlock;
+		const integer toFrame = std::min (iblock * numberOfFramesPerBlock, frames -> nx);
+		const integer firstSample = Sampled_xToLowIndex (me, Sampled_indexToX (frames, fromFrame) - margin);
+		const integer lastSample = Sampled_xToHighIndex (me, Sampled_indexToX (frames, toFrame) + margin);
+		autoSound block = LongSound_extractSamples (me, firstSample, lastSample);
+		analyseBlock (block.get(), fromFrame, toFrame);
+		Melder_progress ((double) iblock / numberOfBlocks, U"Analysed ", Melder_iround (Sampled_indexToX (frames, toFrame)),
+				U" of ", Melder_iround (my xmax), U" seconds");
+	}
+}
+
 static void _LongSound_readSamples (LongSound me, int16 *buffer, const integer imin, const integer imax) {
 	LongSound_readAudioToShort (me, buffer, imin, imax - imin + 1);
 }
@@ -65,6 +65,25 @@ autoLongSound LongSound_open (MelderFile file);
 
 autoSound LongSound_extractPart (LongSound me, double tmin, double tmax, bool preserveTimes);
 
+autoSound LongSound_extractSamples (LongSound me, integer firstSample, integer lastSample);
+/*
+	Reads the samples firstSample .. lastSample (clipped to 1 .. my nx) into a Sound
+	whose samples lie at the same times as in the LongSound;
+	the time domain of the Sound is exactly that of the samples read.
+*/
+
+void LongSound_analyseInBlocks (LongSound me, constSampled frames, double margin,
+	std::function <void (Sound block, integer fromFrame, integer toFrame)> const& analyseBlock);
+/*
+	Streaming analysis: for consecutive blocks of the frames of `frames` (typically an empty analysis result
+	whose time grid was computed for the whole LongSound), reads the samples from
+	`margin` seconds before the first frame centre to `margin` seconds after the last frame centre
+	(as far as they exist), and hands them to `analyseBlock`, which is allowed to modify the block.
+	A block holds about one minute of frames, so that the memory use does not depend on the duration of the LongSound;
+	if the margin includes everything that the analysis of a frame looks at,
+	the result is identical to that of analysing the whole sound in one go.
+*/
+
 bool LongSound_haveWindow (LongSound me, double tmin, double tmax);
 /*
  * Returns 0 if error or if window exceeds buffer, otherwise 1;
@@ -348,12 +348,13 @@ autoSound Sound_Point_Pitch_Duration_to_Sound (Sound me, PointProcess pulses,
 		/*
 		 * Below, I'll abbreviate the voiced interval as "voice" and the voiceless interval as "noise".
 		 */
+		RealTierCursor pitchCursor (pitch);   // the source times increase throughout
 		if (pitch && pitch -> points.size) for (ipointleft = 1; ipointleft <= pulses -> nt; ipointleft = ipointright + 1) {
 			/*
 			 * Find the beginning of the voice.
 			 */
 			startOfSourceVoice = pulses -> t [ipointleft];   // the first pulse of the voice
-			startingPeriod = 1.0 / RealTier_getValueAtTime (pitch, startOfSourceVoice);
+			startingPeriod = 1.0 / pitchCursor.getValueAtTime (startOfSourceVoice);
 			startOfSourceVoice -= 0.5 * startingPeriod;   // the first pulse is in the middle of a period
 
 			/*
@@ -396,7 +397,7 @@ autoSound Sound_Point_Pitch_Duration_to_Sound (Sound me, PointProcess pulses,
 					break;
 			ipointright --;
 			endOfSourceVoice = pulses -> t [ipointright];   // the last pulse of the voice
-			const double finishingPitch = RealTier_getValueAtTime (pitch, endOfSourceVoice);
+			const double finishingPitch = pitchCursor.getValueAtTime (endOfSourceVoice);
 			if (finishingPitch == 0.0) {
 				for (integer ipoint = 1; ipoint <= pitch -> points.size; ipoint ++)
 					Melder_casual (U"Pitch point ", ipoint, U" is ", pitch -> points.at [ipoint], U" Hz");
@@ -434,7 +435,7 @@ autoSound Sound_Point_Pitch_Duration_to_Sound (Sound me, PointProcess pulses,
 						tright = tsourcemid;
 				}
 				const double tsource = 0.5 * (tleft + tright);
-				const double period = 1.0 / RealTier_getValueAtTime (pitch, tsource);
+				const double period = 1.0 / pitchCursor.getValueAtTime (tsource);
 				const integer isourcepulse = PointProcess_getNearestIndex (pulses, tsource);
 				copyBell2 (me, pulses, isourcepulse, period, period, thee.get(), ttarget, maxT);
 				ttarget += period;
@@ -20,6 +20,7 @@
 #include "NUM2.h"
 #include "Formula.h"
 #include "Eigen.h"
+#include "MelderThread.h"
 
 #include "oo_DESTROY.h"
 #include "Matrix_def.h"
@@ -733,14 +734,44 @@ void Matrix_writeToHeaderlessSpreadsheetFile (const constMatrix me, MelderFile f
 	}
 }
 
+/*
+	The cells are divided into stretches of at most 4096 columns within a row,
+	so that a one-channel sound of an hour can be spread over all threads.
+*/
+static void Matrix_runBlockProgram (const mutableMatrix target, const FormulaBlockProgram program,
+	const integer fromRow, const integer toRow, const integer fromColumn, const integer toColumn)
+{
+	constexpr integer maximumNumberOfColumnsPerStretch = 4096;
+	if (toRow < fromRow || toColumn < fromColumn)
+		return;
+	const integer numberOfStretchesPerRow = 1 + (toColumn - fromColumn) / maximumNumberOfColumnsPerStretch;
+	const integer numberOfStretches = (toRow - fromRow + 1) * numberOfStretchesPerRow;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfStretches, 4);
+	MelderThread_runChunked (numberOfThreads, numberOfStretches, 0,
+		[&] (integer /* ithread */, integer fromStretch, integer toStretch) {
+			for (integer istretch = fromStretch; istretch <= toStretch; istretch ++) {
+				const integer irow = fromRow + (istretch - 1) / numberOfStretchesPerRow;
+				const integer firstColumn = fromColumn + (istretch - 1) % numberOfStretchesPerRow * maximumNumberOfColumnsPerStretch;
+				const integer lastColumn = std::min (firstColumn + maximumNumberOfColumnsPerStretch - 1, toColumn);
+				FormulaBlockProgram_run (program, irow, firstColumn, target -> z [irow]. part (firstColumn, lastColumn));
+			}
+		}
+	);
+}
+
 void Matrix_formula (const mutableMatrix me,
 	conststring32 expression, Interpreter interpreter, /* mutable default */ mutableMatrix target)
 {
 	try {
 		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
 		if (! target)
 			target = me;
+		autoFormulaBlockProgram program = Formula_toBlockProgram ();
+		if (program) {
+			Matrix_runBlockProgram (target, program.get(), 1, my ny, 1, my nx);
+			return;
+		}
+		Formula_Result result;
 		for (integer irow = 1; irow <= my ny; irow ++) {
 			for (integer icol = 1; icol <= my nx; icol ++) {
 				Formula_run (irow, icol, & result);
@@ -765,9 +796,14 @@ void Matrix_formula_part (const mutableMatrix me, double xmin, double xmax, doub
 		(void) Matrix_getWindowSamplesX (me, xmin, xmax, & ixmin, & ixmax);
 		(void) Matrix_getWindowSamplesY (me, ymin, ymax, & iymin, & iymax);
 		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
 		if (! target)
 			target = me;
+		autoFormulaBlockProgram program = Formula_toBlockProgram ();
+		if (program) {
+			Matrix_runBlockProgram (target, program.get(), iymin, iymax, ixmin, ixmax);
+			return;
+		}
+		Formula_Result result;
 		for (integer irow = iymin; irow <= iymax; irow ++) {
 			for (integer icol = ixmin; icol <= ixmax; icol ++) {
 				Formula_run (irow, icol, & result);
@@ -134,9 +134,10 @@ autoPitchTier PitchTier_PointProcess_to_PitchTier (PitchTier me, PointProcess pp
 		Melder_require (my points.size > 0,
 			U"No pitch points.");
 		autoPitchTier thee = PitchTier_create (pp -> xmin, pp -> xmax);
+		RealTierCursor pitch (me);
 		for (integer i = 1; i <= pp -> nt; i ++) {
 			const double time = pp -> t [i];
-			const double value = RealTier_getValueAtTime (me, time);
+			const double value = pitch.getValueAtTime (time);
 			RealTier_addPoint (thee.get(), time, value);
 		}
 		return thee;
@@ -81,9 +81,10 @@ autoSound PitchTier_to_Sound_sine (PitchTier me, double tmin, double tmax, doubl
 		double t1 = tmid - 0.5 * (numberOfSamples - 1) * samplingPeriod;
 		autoSound thee = Sound_create (1, tmin, tmax, numberOfSamples, samplingPeriod, t1);
 		double phase = 0.0;
+		RealTierCursor pitch (me);
 		for (integer isamp = 2; isamp <= numberOfSamples; isamp ++) {
 			double tleft = t1 + (isamp - 1.5) * samplingPeriod;
-			double fleft = RealTier_getValueAtTime (me, tleft);
+			double fleft = pitch.getValueAtTime (tleft);
 			phase += fleft * thy dx;
 			thy z [1] [isamp] = 0.5 * sin (2.0 * NUMpi * phase);
 		}
@@ -28,6 +28,7 @@
 #include "Graphics.h"
 #include "praat.h"
 #include "NUM2.h"
+#include "cblas.h"
 #include "Sound.h"
 
 #include "enums_getText.h"
@@ -464,7 +465,8 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 			double sum = NUMsum (result.get());
 			MelderInfo_writeLine (sum);
 		} break;
-		case kPraatTests::TIME_MATMUL: {
+		case kPraatTests::TIME_MATMUL:
+		case kPraatTests::TIME_MATMUL_FAST: {
 			const integer size1 = Melder_atoi (arg2);
 			integer size2 = Melder_atoi (arg3);
 			integer size3 = Melder_atoi (arg4);
@@ -482,7 +484,10 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 			Melder_stopwatch ();
 			for (integer iteration = 1; iteration <= n; iteration ++)
 				//MATmul_forceMetal_ (result_all, x_all, y_all);
-				_mul_allowAllocation_MAT_out (result_all, x_all, y_all);
+				if (itest == kPraatTests::TIME_MATMUL_FAST)
+					_mul_fast_MAT_out (result_all, x_all, y_all);
+				else
+					_mul_allowAllocation_MAT_out (result_all, x_all, y_all);
 			const integer numberOfComputations = size1 * size2 * size3 * 2;
 			t = Melder_stopwatch () / numberOfComputations;
 			const double sum = NUMsum (result.get());
@@ -662,6 +667,133 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 		case kPraatTests::FILEINMEMORYMANAGER_IO: {
 			test_FileInMemoryManager_io ();
 		} break;
+		case kPraatTests::TIME_FFT_UNCACHED:
+		case kPraatTests::TIME_FFT: {
+			/*
+				A table for every transform, as in Sound_to_Spectrum ();
+				the uncached version computes the twiddle factors every time, as before the plan cache existed.
+			*/
+			const integer size = Melder_atoi (arg2);
+			autoVEC data = randomGauss_VEC (size, 0.0, 1.0);
+			Melder_stopwatch ();
+			for (int64 iteration = 1; iteration <= n; iteration ++) {
+				autoNUMfft_Table table;
+				if (itest == kPraatTests::TIME_FFT_UNCACHED) {
+					table.plan = std::make_shared <structNUMfft_Plan> ();
+					NUMfft_Plan_init (table.plan.get(), size);
+					table.work = raw_VEC (size);
+					table.n = size;
+				} else {
+					NUMfft_Table_init (& table, size);
+				}
+				NUMfft_forward (& table, data.get());
+				data [1] = 0.0;   // against overflow
+			}
+			t = Melder_stopwatch () / (2.5 * size * log2 (size));   // approximate number of operations of a real FFT
+		} break;
+		case kPraatTests::TIME_FFT_BATCH: {
+			const integer size = Melder_atoi (arg2);
+			integer numberOfFrames = Melder_atoi (arg3);
+			if (numberOfFrames == 0)
+				numberOfFrames = 100;
+			autoMAT frames = randomGauss_MAT (numberOfFrames, size, 0.0, 1.0);
+			autoNUMfft_Table table;
+			NUMfft_Table_init (& table, size);
+			/*
+				Check that the batched transform equals the transforms of the separate frames.
+			*/
+			autoMAT check = copy_MAT (frames.get());
+			NUMfft_forward (& table, check.get());
+			for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
+				autoVEC frame = copy_VEC (frames.row (iframe));
+				NUMfft_forward (& table, frame.get());
+				for (integer i = 1; i <= size; i ++)
+					Melder_assert (frame [i] == check [iframe] [i]);
+			}
+			Melder_stopwatch ();
+			for (int64 iteration = 1; iteration <= n; iteration ++) {
+				NUMfft_forward (& table, frames.get());
+				NUMfft_backward (& table, frames.get());
+				frames.all()  *=  1.0 / size;   // against overflow
+			}
+			t = Melder_stopwatch () / (2 * numberOfFrames * 2.5 * size * log2 (size));
+		} break;
+		case kPraatTests::CHECK_BLAS3: {
+			/*
+				Compare the blocked level-3 BLAS routines with the reference routines,
+				for all options, with sizes that are not multiples of the block sizes
+				and leading dimensions that are greater than the numbers of rows.
+			*/
+			integer size = Melder_atoi (arg2);
+			if (size == 0)
+				size = 300;
+			integer m = size, ncol = size - 37, k = size / 2 + 3, ld = size + 5;
+			double alpha = 0.7, beta = 0.3;
+			autoVEC a = randomGauss_VEC (ld * ld, 0.0, 1.0), b = randomGauss_VEC (ld * ld, 0.0, 1.0);
+			autoVEC c = randomGauss_VEC (ld * ld, 0.0, 1.0);
+			autoVEC blocked = raw_VEC (ld * ld), reference = raw_VEC (ld * ld);
+			auto compare = [&] (conststring32 routine, conststring32 options, double blockedDuration, double referenceDuration) {
+				double maximumDifference = 0.0, maximumValue = 0.0;
+				for (integer i = 1; i <= ld * ld; i ++) {
+					Melder_clipLeft (fabs (blocked [i] - reference [i]), & maximumDifference);
+					Melder_clipLeft (fabs (reference [i]), & maximumValue);
+				}
+				const double relativeDifference = maximumDifference / maximumValue;
+				MelderInfo_writeLine (routine, U" ", options, U": relative difference ", relativeDifference,
+						U", speed-up ", Melder_fixed (referenceDuration / blockedDuration, 2));
+				Melder_require (relativeDifference < 1e-12,
+					U"The blocked ", routine, U" (", options, U") differs from the reference routine.");
+			};
+			for (int itrans = 0; itrans < 4; itrans ++) {
+				const char *transa = ( itrans & 1 ? "T" : "N" ), *transb = ( itrans & 2 ? "T" : "N" );
+				blocked.all()  <<=  c.all();
+				reference.all()  <<=  c.all();
+				Melder_stopwatch ();
+				dgemm_ (transa, transb, & m, & ncol, & k, & alpha, & a [1], & ld, & b [1], & ld, & beta, & blocked [1], & ld);
+				const double blockedDuration = Melder_stopwatch ();
+				dgemm_reference_ (transa, transb, & m, & ncol, & k, & alpha, & a [1], & ld, & b [1], & ld, & beta, & reference [1], & ld);
+				const double referenceDuration = Melder_stopwatch ();
+				compare (U"dgemm", Melder_cat (itrans & 1 ? U"T" : U"N", itrans & 2 ? U"T" : U"N"), blockedDuration, referenceDuration);
+			}
+			for (int ioption = 0; ioption < 4; ioption ++) {
+				const char *uplo = ( ioption & 1 ? "L" : "U" ), *trans = ( ioption & 2 ? "T" : "N" );
+				blocked.all()  <<=  c.all();
+				reference.all()  <<=  c.all();
+				Melder_stopwatch ();
+				dsyrk_ (uplo, trans, & m, & k, & alpha, & a [1], & ld, & beta, & blocked [1], & ld);
+				double blockedDuration = Melder_stopwatch ();
+				dsyrk_reference_ (uplo, trans, & m, & k, & alpha, & a [1], & ld, & beta, & reference [1], & ld);
+				double referenceDuration = Melder_stopwatch ();
+				compare (U"dsyrk", Melder_cat (ioption & 1 ? U"L" : U"U", ioption & 2 ? U"T" : U"N"), blockedDuration, referenceDuration);
+				blocked.all()  <<=  c.all();
+				reference.all()  <<=  c.all();
+				Melder_stopwatch ();
+				dsyr2k_ (uplo, trans, & m, & k, & alpha, & a [1], & ld, & b [1], & ld, & beta, & blocked [1], & ld);
+				blockedDuration = Melder_stopwatch ();
+				dsyr2k_reference_ (uplo, trans, & m, & k, & alpha, & a [1], & ld, & b [1], & ld, & beta, & reference [1], & ld);
+				referenceDuration = Melder_stopwatch ();
+				compare (U"dsyr2k", Melder_cat (ioption & 1 ? U"L" : U"U", ioption & 2 ? U"T" : U"N"), blockedDuration, referenceDuration);
+			}
+			/*
+				A well-conditioned triangular matrix: small off-diagonal elements and a dominant diagonal.
+			*/
+			autoVEC triangular = randomGauss_VEC (ld * ld, 0.0, 1.0 / size);
+			for (integer i = 0; i < size; i ++)
+				triangular [1 + i + i * ld] = 1.0 + fabs (triangular [1 + i + i * ld]) * size;
+			for (int ioption = 0; ioption < 16; ioption ++) {
+				const char *side = ( ioption & 1 ? "R" : "L" ), *uplo = ( ioption & 2 ? "L" : "U" );
+				const char *transa = ( ioption & 4 ? "T" : "N" ), *diag = ( ioption & 8 ? "U" : "N" );
+				blocked.all()  <<=  c.all();
+				reference.all()  <<=  c.all();
+				Melder_stopwatch ();
+				dtrsm_ (side, uplo, transa, diag, & m, & ncol, & alpha, & triangular [1], & ld, & blocked [1], & ld);
+				const double blockedDuration = Melder_stopwatch ();
+				dtrsm_reference_ (side, uplo, transa, diag, & m, & ncol, & alpha, & triangular [1], & ld, & reference [1], & ld);
+				const double referenceDuration = Melder_stopwatch ();
+				compare (U"dtrsm", Melder_cat (ioption & 1 ? U"R" : U"L", ioption & 2 ? U"L" : U"U",
+						ioption & 4 ? U"T" : U"N", ioption & 8 ? U"U" : U"N"), blockedDuration, referenceDuration);
+			}
+		} break;
 	}
 	MelderInfo_writeLine (Melder_single (n / t * 1e-9), U" Gflop/s");
 	MelderInfo_close ();
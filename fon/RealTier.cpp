@@ -128,6 +128,17 @@ double RealTier_getValueAtIndex (const constRealTier me, const integer i) {
 	return my points.at [i] -> value;
 }
 
+static inline double interpolateBetweenPoints (const constRealTier me, const integer ileft, const double t) {
+	Melder_assert (ileft >= 1 && ileft < my points.size);
+	const RealPoint pointLeft = my points.at [ileft];
+	const RealPoint pointRight = my points.at [ileft + 1];
+	const double tleft = pointLeft -> number, fleft = pointLeft -> value;
+	const double tright = pointRight -> number, fright = pointRight -> value;
+	return t == tright ? fright   // be very accurate
+		: tleft == tright ? 0.5 * (fleft + fright)   // unusual, but possible; no preference
+		: fleft + (t - tleft) * (fright - fleft) / (tright - tleft);   // linear interpolation
+}
+
 double RealTier_getValueAtTime (const constRealTier me, const double t) {
 	const integer n = my points.size;
 	if (n == 0)
@@ -139,15 +150,43 @@ double RealTier_getValueAtTime (const constRealTier me, const double t) {
 	if (t >= lastPoint -> number)
 		return lastPoint -> value;   // constant extrapolation
 	Melder_assert (n >= 2);
-	const integer ileft = AnyTier_timeToLowIndex (me->asConstAnyTier(), t), iright = ileft + 1;
-	Melder_assert (ileft >= 1 && iright <= n);
-	const RealPoint pointLeft = my points.at [ileft];
-	const RealPoint pointRight = my points.at [iright];
-	const double tleft = pointLeft -> number, fleft = pointLeft -> value;
-	const double tright = pointRight -> number, fright = pointRight -> value;
-	return t == tright ? fright   // be very accurate
-		: tleft == tright ? 0.5 * (fleft + fright)   // unusual, but possible; no preference
-		: fleft + (t - tleft) * (fright - fleft) / (tright - tleft);   // linear interpolation
+	const integer ileft = AnyTier_timeToLowIndex (me->asConstAnyTier(), t);
+	return interpolateBetweenPoints (me, ileft, t);
+}
+
+double RealTierCursor :: getValueAtTime (const double t) {
+	const integer n = our tier -> points.size;
+	if (n == 0)
+		return undefined;
+	const RealPoint firstPoint = our tier -> points.at [1];
+	if (t <= firstPoint -> number)
+		return firstPoint -> value;   // constant extrapolation
+	const RealPoint lastPoint = our tier -> points.at [n];
+	if (t >= lastPoint -> number)
+		return lastPoint -> value;   // constant extrapolation
+	Melder_assert (n >= 2);
+	/*
+		Now the time of point 1 < t < the time of point n.
+		We need the last point at or before t, which is the one that AnyTier_timeToLowIndex () would find.
+	*/
+	if (our ileft < 1 || our ileft >= n || t < our tier -> points.at [our ileft] -> number)
+		our ileft = AnyTier_timeToLowIndex (our tier -> asConstAnyTier(), t);   // first time, or a step back
+	else
+		while (t >= our tier -> points.at [our ileft + 1] -> number)
+			our ileft += 1;   // stops before n, because t < the time of point n
+	return interpolateBetweenPoints (our tier, our ileft, t);
+}
+
+void RealTier_listValuesAtRegularTimes_out (const constRealTier me, const double t1, const double dt, VECVU const& values) {
+	RealTierCursor cursor (me);
+	for (integer i = 1; i <= values.size; i ++)
+		values [i] = cursor.getValueAtTime (t1 + (i - 1) * dt);
+}
+
+autoVEC RealTier_listValuesAtRegularTimes (const constRealTier me, const double t1, const double dt, const integer numberOfTimes) {
+	autoVEC result = raw_VEC (numberOfTimes);
+	RealTier_listValuesAtRegularTimes_out (me, t1, dt, result.all());
+	return result;
 }
 
 double RealTier_getMaximumValue (const constRealTier me) {
@@ -55,6 +55,27 @@ double RealTier_getValueAtTime (constRealTier me, double t);
 /* Outside points: constant extrapolation. */
 /* No points: undefined. */
 
+struct RealTierCursor {
+	constRealTier tier;
+	integer ileft = 0;   // the point at or before the previous time, or 0
+	explicit RealTierCursor (constRealTier givenTier) : tier (givenTier) { }
+	double getValueAtTime (double t);
+};
+/*
+	For evaluating a tier at a sequence of increasing times, such as sample times:
+	every value equals RealTier_getValueAtTime (tier, t), but instead of a binary search for each time,
+	the cursor steps forward from where the previous time was found,
+	so that a whole sweep costs O (numberOfTimes + numberOfPoints).
+	A step back in time is allowed, but costs a binary search.
+*/
+
+autoVEC RealTier_listValuesAtRegularTimes (constRealTier me, double t1, double dt, integer numberOfTimes);
+void RealTier_listValuesAtRegularTimes_out (constRealTier me, double t1, double dt, VECVU const& values);
+/*
+	values [i] = RealTier_getValueAtTime (me, t1 + (i - 1) * dt), computed in one sweep with a RealTierCursor.
+	Typically t1 and dt are the x1 and dx of a Sound, for a value at every sample.
+*/
+
 double RealTier_getMinimumValue (constRealTier me);
 double RealTier_getMaximumValue (constRealTier me);
 double RealTier_getArea (constRealTier me, double tmin, double tmax);
@@ -25,6 +25,7 @@
 #include "Sound.h"
 #include "Sound_extensions.h"
 #include "NUM2.h"
+#include "MelderThread.h"
 
 #include "enums_getText.h"
 #include "Sound_enums.h"
@@ -396,6 +397,116 @@ autoSound Sound_upsample (constSound me) {
 	}
 }
 
+/*
+	Polyphase windowed-sinc resampling, for sampling frequencies whose ratio is a fraction
+	with a small numerator L (upsampling factor) and denominator M (downsampling factor),
+	such as 48000 -> 16000 (L = 1, M = 3) or 44100 -> 16000 (L = 160, M = 441).
+	The output sample times lie at a constant fractional offset plus multiples of M/L input samples,
+	so that only L different filters ever occur; these are computed once, beforehand.
+	The anti-aliasing low-pass filter is built into the sinc, so that no full-length FFT is needed,
+	and the memory use is independent of the duration of the sound.
+*/
+static bool Sound_getResamplingFraction (constSound me, double samplingFrequency, integer *out_L, integer *out_M) {
+	constexpr integer maximumL = 1000;
+	const double oldSamplingFrequency = 1.0 / my dx;
+	const double roundedOld = round (oldSamplingFrequency), roundedNew = round (samplingFrequency);
+	if (roundedOld < 1.0 || roundedNew < 1.0 ||
+		fabs (oldSamplingFrequency - roundedOld) > 1e-12 * roundedOld || fabs (samplingFrequency - roundedNew) > 1e-9 * roundedNew ||
+		roundedOld > 1e9 || roundedNew > 1e9
+	)
+		return false;
+	integer a = integer (roundedNew), b = integer (roundedOld);
+	while (b != 0) {
+		const integer remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	const integer greatestCommonDivisor = a;
+	const integer L = integer (roundedNew) / greatestCommonDivisor, M = integer (roundedOld) / greatestCommonDivisor;
+	if (L > maximumL)
+		return false;
+	*out_L = L;
+	*out_M = M;
+	return true;
+}
+
+static autoSound Sound_resample_polyphase (constSound me, double samplingFrequency, integer precision,
+	integer numberOfSamples, integer L, integer M)
+{
+	autoSound thee = Sound_create (my ny, my xmin, my xmax, numberOfSamples, 1.0 / samplingFrequency,
+			0.5 * (my xmin + my xmax - (numberOfSamples - 1) / samplingFrequency));
+	/*
+		Cut-off at the lower of the two Nyquist frequencies, relative to the old one.
+	*/
+	const double cutoff = std::min (1.0, double (L) / double (M));
+	/*
+		The half-width of the filter, in old samples: `precision` sinc lobes.
+	*/
+	const integer halfWidth = Melder_iroundUp (precision / cutoff);
+	const integer numberOfTaps = 2 * halfWidth + 1;   // one extra to absorb the carry in the phase
+	/*
+		The real index of the first new sample in the old sound is firstIndex = base + offset,
+		with 0 <= offset < 1; new sample i then lies at old index base + offset + (i - 1) * M / L.
+	*/
+	const double firstIndex = Sampled_xToIndex (me, thy x1);
+	const integer base = Melder_ifloor (firstIndex);
+	const double offset = firstIndex - base;
+	autoMAT bank = raw_MAT (L, numberOfTaps);
+	for (integer iphase = 1; iphase <= L; iphase ++) {
+		const double phaseOffset = offset + double (iphase - 1) / L;   // 0 .. 2
+		longdouble sum = 0.0;
+		for (integer itap = 1; itap <= numberOfTaps; itap ++) {
+			const integer k = itap - halfWidth;   // from -halfWidth + 1 to halfWidth + 1
+			const double distance = phaseOffset - k;   // in old samples
+			double weight = 0.0;
+			if (fabs (distance) < halfWidth) {
+				const double phase = NUMpi * cutoff * distance;
+				const double sinc = ( phase == 0.0 ? 1.0 : sin (phase) / phase );
+				weight = sinc * (0.5 + 0.5 * cos (NUMpi * distance / halfWidth));
+			}
+			bank [iphase] [itap] = weight;
+			sum += weight;
+		}
+		bank.row (iphase)  /=  double (sum);   // unit gain at zero frequency, for every phase
+	}
+	/*
+		The channels, and long stretches within each channel, are independent.
+	*/
+	constexpr integer blockSize = 65536;
+	const integer numberOfBlocksPerChannel = 1 + (numberOfSamples - 1) / blockSize;
+	const integer numberOfBlocks = my ny * numberOfBlocksPerChannel;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfBlocks, 1);
+	MelderThread_runChunked (numberOfThreads, numberOfBlocks, 1,
+		[&] (integer /* ithread */, integer fromBlock, integer toBlock) {
+			for (integer iblock = fromBlock; iblock <= toBlock; iblock ++) {
+				const integer ichan = 1 + (iblock - 1) / numberOfBlocksPerChannel;
+				const integer firstSample = 1 + ((iblock - 1) % numberOfBlocksPerChannel) * blockSize;
+				const integer lastSample = std::min (firstSample + blockSize - 1, numberOfSamples);
+				const constVEC from = my z.row (ichan);
+				const VEC to = thy z.row (ichan);
+				for (integer i = firstSample; i <= lastSample; i ++) {
+					const integer numerator = (i - 1) * M;
+					const integer leftSample = base + numerator / L;
+					const constVEC weights = bank.row (1 + numerator % L);
+					const integer firstTap = leftSample - halfWidth + 1;   // old sample that goes with weights [1]
+					const integer lastTap = firstTap + numberOfTaps - 1;
+					longdouble sum = 0.0;
+					if (firstTap >= 1 && lastTap <= my nx) {
+						const double *x = & from [firstTap - 1];
+						for (integer itap = 1; itap <= numberOfTaps; itap ++)
+							sum += weights [itap] * x [itap];
+					} else {
+						for (integer itap = std::max (1_integer, 2 - firstTap); itap <= numberOfTaps && firstTap + itap - 1 <= my nx; itap ++)
+							sum += weights [itap] * from [firstTap + itap - 1];   // zero outside the sound
+					}
+					to [i] = double (sum);
+				}
+			}
+		}
+	);
+	return thee;
+}
+
 autoSound Sound_resample (constSound me, double samplingFrequency, integer precision) {
 	const double upfactor = samplingFrequency * my dx;
 	if (fabs (upfactor - 2.0) < 1e-6)
@@ -406,6 +517,10 @@ autoSound Sound_resample (constSound me, double samplingFrequency, integer preci
 		const integer numberOfSamples = Melder_iround ((my xmax - my xmin) * samplingFrequency);
 		if (numberOfSamples < 1)
 			Melder_throw (U"The resampled Sound would have no samples.");
+		integer L, M;
+		if (precision > 1 && Sound_getResamplingFraction (me, samplingFrequency, & L, & M) &&
+				double (numberOfSamples) * double (M) < 1e18)   // no integer overflow in the phase computation
+			return Sound_resample_polyphase (me, samplingFrequency, precision, numberOfSamples, L, M);
 		autoSound filtered;
 		const bool weNeedAnAntiAliasingFilter = ( upfactor < 1.0 );
 		if (weNeedAnAntiAliasingFilter) {
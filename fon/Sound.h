@@ -115,6 +115,10 @@ autoSound Sound_resample (constSound me, double samplingFrequency, integer preci
 	Method:
 		precision <= 1: linear interpolation.
 		precision >= 2: sinx/x interpolation with maximum depth equal to 'precision'.
+			If the two sampling frequencies are whole numbers of hertz whose ratio is L/M with L <= 1000
+			(e.g. 48000 -> 16000, 44100 -> 16000, 22050 -> 44100), a polyphase windowed-sinc filter bank is used,
+			with 'precision' sinc lobes on either side, at the lower of the two Nyquist frequencies;
+			otherwise the whole sound is low-pass filtered via the FFT (if downsampling) and interpolated sample by sample.
 */
 
 autoSound Sounds_append (constSound me, double silenceDuration, constSound thee);
@@ -307,11 +311,18 @@ void Sound_play (constSound me, Sound_PlayCallback playCallback, Thing playBoss)
 void Sound_saveAsAudioFile (constSound me, MelderFile file, int audioFileType, int numberOfBitsPerSamplePoint);
 void Sound_saveAsKayFile (constSound me, MelderFile file);   // 16-bit
 void Sound_saveAsSesamFile (constSound me, MelderFile file);   // 12-bit SESAM/LVS
+void Sound_saveAsMappableFile (constSound me, MelderFile file);   // 64-bit native, see Sound_readFromMappableFile
 
 autoSound Sound_readFromSoundFile (MelderFile file);   // AIFF, WAV, NeXT/Sun, or NIST
 autoDaata Sound_readFromAnyKayFile (MelderFile file);   // 16-bit
 autoSound Sound_readFromSesamFile (MelderFile file);   // 12-bit SESAM/LVS
 autoSound Sound_readFromBellLabsFile (MelderFile file);   // 16-bit
+bool Sound_isMappableFileHeader (integer nread, const char *header);
+autoSound Sound_readFromMappableFile (MelderFile file);
+/*
+	The samples are not read but mapped from the file: reading is immediate, and a page of samples
+	is read from disk only when it is first used. Changing the Sound does not change the file.
+*/
 autoSound Sound_readFromRawAlawFile (MelderFile file);
 autoSound Sound_readFromMovieFile (MelderFile file);
 
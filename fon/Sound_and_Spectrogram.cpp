@@ -18,12 +18,21 @@
 
 #include "Sound_and_Spectrogram.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
 
 #include "enums_getText.h"
 #include "Sound_and_Spectrogram_enums.h"
 #include "enums_getValue.h"
 #include "Sound_and_Spectrogram_enums.h"
 
+Thing_define (Sound_into_Spectrogram_Workspace, Thing) { public:
+	autoNUMfft_Table fftTable;
+	autoVEC data, spectrum;
+};
+
+Thing_implement (Sound_into_Spectrogram_Workspace, Thing, 0);
+
 autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, double fmax,
 	double minimumTimeStep1, double minimumFreqStep1, kSound_to_Spectrogram_windowShape windowType,
 	double maximumTimeOversampling, double maximumFreqOversampling)
@@ -118,69 +127,88 @@ autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, d
 		}
 		const double oneByBinWidth = 1.0 / double (windowssq) / binWidth_samples;
 
-		autoVEC data = zero_VEC (nsampFFT);
-		autoVEC spectrum = zero_VEC (half_nsampFFT + 1);
-		autoNUMfft_Table fftTable;
-		NUMfft_Table_init (& fftTable, nsampFFT);
+		/*
+			Every thread has its own FFT table and frame buffers;
+			the frames are independent, so the result does not depend on the number of threads.
+		*/
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfTimes, 20);
+		OrderedOf <structSound_into_Spectrogram_Workspace> workspaces;
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			autoSound_into_Spectrogram_Workspace workspace = Thing_new (Sound_into_Spectrogram_Workspace);
+			workspace -> data = zero_VEC (nsampFFT);
+			workspace -> spectrum = zero_VEC (half_nsampFFT + 1);
+			NUMfft_Table_init (& workspace -> fftTable, nsampFFT);
+			workspaces. addItem_move (workspace.move());
+		}
+		std::atomic <integer> numberOfFramesDone (0);
 
 		autoMelderProgress progress (U"Sound to Spectrogram...");
 
-		for (integer iframe = 1; iframe <= numberOfTimes; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
-			const integer startSample = rightSample - halfnsamp_window;
-			const integer endSample = leftSample + halfnsamp_window;
-			Melder_assert (startSample >= 1);
-			Melder_assert (endSample <= my nx);
-
-			spectrum.all()  <<=  0.0;
-			/*
-				For multichannel sounds, the power spectrogram should represent the
-				average power in the channels,
-				so that the result for a stereo sound in which the
-				left channel has the same waveform as the right channel,
-				is identical to the result for the corresponding mono (= averaged) sound.
-				Averaging starts by adding up the powers of the channels.
-			*/
-			for (integer channel = 1; channel <= my ny; channel ++) {
-				for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-					data [j] = my z [channel] [i ++] * window [j];
-				for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
-					data [j] = 0.0f;
-
-				Melder_progress (iframe / (numberOfTimes + 1.0),
-					U"Sound to Spectrogram: analysis of frame ", iframe, U" out of ", numberOfTimes);
-
-				/*
-					Compute the Fast Fourier Transform of the frame.
-				*/
-				NUMfft_forward (& fftTable, data.get());   // data := complex spectrum
-
-				/*
-					Convert from complex to power spectrum,
-					accumulating the power spectra of the channels.
-				*/
-				spectrum [1] += data [1] * data [1];   // DC component
-				for (integer i = 2; i <= half_nsampFFT; i ++)
-					spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
-				spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
-			}
-			/*
-				Power averaging ends by dividing the summed power by the number of channels,
-			*/
-			if (my ny > 1 )
-				spectrum.all()  /=  my ny;
-
-			/*
-				Binning.
-			*/
-			for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
-				const integer lowerSample = (iband - 1) * binWidth_samples + 1;
-				const integer higherSample = lowerSample + binWidth_samples;
-				const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
-				thy z [iband] [iframe] = power * oneByBinWidth;
+		MelderThread_runChunked (numberOfThreads, numberOfTimes, 0,
+			[&] (integer ithread, integer fromFrame, integer toFrame) {
+				Sound_into_Spectrogram_Workspace workspace = workspaces.at [ithread];
+				const VEC data = workspace -> data.get();
+				const VEC spectrum = workspace -> spectrum.get();
+				for (integer iframe = fromFrame; iframe <= toFrame; iframe ++) {
+					const double t = Sampled_indexToX (thee.get(), iframe);
+					const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
+					const integer startSample = rightSample - halfnsamp_window;
+					const integer endSample = leftSample + halfnsamp_window;
+					Melder_assert (startSample >= 1);
+					Melder_assert (endSample <= my nx);
+
+					if (ithread == 1)   // only the calling thread may talk to the user
+						Melder_progress (numberOfFramesDone / (numberOfTimes + 1.0),
+							U"Sound to Spectrogram: analysis of frame ", numberOfFramesDone + 1, U" out of ", numberOfTimes);
+
+					spectrum  <<=  0.0;
+					/*
+						For multichannel sounds, the power spectrogram should represent the
+						average power in the channels,
+						so that the result for a stereo sound in which the
+						left channel has the same waveform as the right channel,
+						is identical to the result for the corresponding mono (= averaged) sound.
+						Averaging starts by adding up the powers of the channels.
+					*/
+					for (integer channel = 1; channel <= my ny; channel ++) {
+						for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
+							data [j] = my z [channel] [i ++] * window [j];
+						for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
+							data [j] = 0.0f;
+
+						/*
+							Compute the Fast Fourier Transform of the frame.
+						*/
+						NUMfft_forward (& workspace -> fftTable, data);   // data := complex spectrum
+
+						/*
+							Convert from complex to power spectrum,
+							accumulating the power spectra of the channels.
+						*/
+						spectrum [1] += data [1] * data [1];   // DC component
+						for (integer i = 2; i <= half_nsampFFT; i ++)
+							spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
+						spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
+					}
+					/*
+						Power averaging ends by dividing the summed power by the number of channels,
+					*/
+					if (my ny > 1 )
+						spectrum  /=  my ny;
+
+					/*
+						Binning.
+					*/
+					for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
+						const integer lowerSample = (iband - 1) * binWidth_samples + 1;
+						const integer higherSample = lowerSample + binWidth_samples;
+						const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
+						thy z [iband] [iframe] = power * oneByBinWidth;
+					}
+					++ numberOfFramesDone;
+				}
 			}
-		}
+		);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": spectrogram analysis not performed.");
@@ -548,4 +548,80 @@ void Sound_saveAsRawSoundFile (constSound me, MelderFile file, int encoding) {
 	}
 }
 
+/*
+	A mappable sound file consists of a header of 4096 bytes, followed by the samples, channel after channel,
+	as 64-bit floating-point numbers in the byte order of the computer that wrote the file.
+	When such a file is read, the samples are not copied into memory but mapped:
+	reading takes no time, parts of the Sound are read from disk only when they are used,
+	and parts that are changed are first copied into memory, so that the file itself never changes.
+	The file should not be changed by other programs as long as the Sound exists.
+*/
+#define MAPPABLE_SOUND_MAGIC  "Praat mappable sound file\n"
+constexpr int64 MAPPABLE_SOUND_HEADER_SIZE = 4096;
+constexpr uint32 MAPPABLE_SOUND_BYTE_ORDER_MARK = 0x0102'0304;
+
+struct MappableSoundHeader {
+	char magic [32];
+	uint32 byteOrderMark, sizeOfDouble;
+	int64 numberOfChannels, numberOfSamples;
+	double xmin, xmax, dx, x1;
+};
+
+bool Sound_isMappableFileHeader (integer nread, const char *header) {
+	return nread >= (integer) sizeof (MappableSoundHeader) && strnequ (header, MAPPABLE_SOUND_MAGIC, strlen (MAPPABLE_SOUND_MAGIC));
+}
+
+void Sound_saveAsMappableFile (constSound me, MelderFile file) {
+	try {
+		autofile f = Melder_fopen (file, "wb");
+		char header [MAPPABLE_SOUND_HEADER_SIZE];
+		memset (header, 0, sizeof header);
+		MappableSoundHeader description;
+		memset (& description, 0, sizeof description);
+		strcpy (description.magic, MAPPABLE_SOUND_MAGIC);
+		description.byteOrderMark = MAPPABLE_SOUND_BYTE_ORDER_MARK;
+		description.sizeOfDouble = sizeof (double);
+		description.numberOfChannels = my ny;
+		description.numberOfSamples = my nx;
+		description.xmin = my xmin;
+		description.xmax = my xmax;
+		description.dx = my dx;
+		description.x1 = my x1;
+		memcpy (header, & description, sizeof description);
+		if (fwrite (header, 1, sizeof header, f) != sizeof header)
+			Melder_throw (U"Header not written.");
+		const constVEC samples = my z.get().asvector();   // all channels, contiguously
+		if (fwrite (samples.cells, sizeof (double), size_t (samples.size), f) != size_t (samples.size))
+			Melder_throw (U"Samples not written.");
+		f.close (file);
+	} catch (MelderError) {
+		Melder_throw (me, U": not written to mappable sound file ", file, U".");
+	}
+}
+
+autoSound Sound_readFromMappableFile (MelderFile file) {
+	try {
+		autofile f = Melder_fopen (file, "rb");
+		MappableSoundHeader description;
+		if (fread (& description, sizeof description, 1, f) != 1)
+			Melder_throw (U"File too short.");
+		Melder_require (strnequ (description.magic, MAPPABLE_SOUND_MAGIC, strlen (MAPPABLE_SOUND_MAGIC)),
+			U"Not a mappable sound file.");
+		Melder_require (description.byteOrderMark == MAPPABLE_SOUND_BYTE_ORDER_MARK && description.sizeOfDouble == sizeof (double),
+			U"This file was written on a computer with a different number format, and cannot be mapped on this computer. "
+			U"Save the Sound as a binary file instead (on the computer where the file was made).");
+		Melder_require (description.numberOfChannels >= 1 && description.numberOfSamples >= 1 &&
+				description.xmax > description.xmin && description.dx > 0.0,
+			U"Wrong header information.");
+		autoSound me = Thing_new (Sound);
+		SampledXY_init (me.get(), description.xmin, description.xmax, description.numberOfSamples, description.dx, description.x1,
+				1.0, description.numberOfChannels, description.numberOfChannels, 1.0, 1.0);
+		my z = mapped_MAT (f, MAPPABLE_SOUND_HEADER_SIZE, my ny, my nx);
+		f.close (file);   // the mapping survives the closing of the file
+		return me;
+	} catch (MelderError) {
+		Melder_throw (U"Sound not read from mappable sound file ", file, U".");
+	}
+}
+
 /* End of file Sound_files.cpp */
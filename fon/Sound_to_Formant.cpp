@@ -287,30 +287,40 @@ void Formant_sort (Formant me) {
 	}
 }
 
-static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer numberOfPoles,
-	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
+/*
+	The frame grid of a formant analysis of a sound with the samples nx, dx, x1,
+	fitting as many frames as possible symmetrically in the total duration;
+	if the sound is shorter than the window, there is a single frame, and the window shrinks to the sound.
+*/
+static void getFrameGrid (integer nx, double dx, double x1, double dt, integer numberOfPoles, double halfdt_window,
+	integer *out_numberOfFrames, double *out_t1, integer *out_nsamp_window)
 {
-	const double dt = ( dt_in > 0.0 ? dt_in : halfdt_window / 4.0 );
-	const double physicalDuration = my nx * my dx;
-	double dt_window = 2.0 * halfdt_window;
+	const double physicalDuration = nx * dx;
+	const double dt_window = 2.0 * halfdt_window;
 	integer nFrames = 1 + Melder_ifloor ((physicalDuration - dt_window) / dt);
-	integer nsamp_window = Melder_ifloor (dt_window / my dx), halfnsamp_window = nsamp_window / 2;
-
+	integer nsamp_window = Melder_ifloor (dt_window / dx);
 	if (nsamp_window < numberOfPoles + 1)
 		Melder_throw (U"Window too short.");
-	double t1 = my x1 + 0.5 * (physicalDuration - my dx - (nFrames - 1) * dt);   // centre of first frame
+	double t1 = x1 + 0.5 * (physicalDuration - dx - (nFrames - 1) * dt);   // centre of first frame
 	if (nFrames < 1) {
 		nFrames = 1;
-		t1 = my x1 + 0.5 * physicalDuration;
-		dt_window = physicalDuration;
-		nsamp_window = my nx;
+		t1 = x1 + 0.5 * physicalDuration;
+		nsamp_window = nx;
 	}
-	autoFormant thee = Formant_create (my xmin, my xmax, nFrames, dt, t1, (numberOfPoles + 1) / 2);   // e.g. 11 poles -> maximally 6 formants
-
-	autoMelderProgress progress (U"Formant analysis...");
+	*out_numberOfFrames = nFrames;
+	*out_t1 = t1;
+	*out_nsamp_window = nsamp_window;
+}
 
-	/* Pre-emphasis. */
-	Sound_preEmphasize_inplace (me, preemphasisFrequency);
+/*
+	Computes the frames fromFrame .. toFrame of `thee` from the pre-emphasized sound `me`,
+	which has to contain the samples around those frames.
+	The sample numbers are computed on `sampleGrid`, which is either `me` or the (resampled) sound that `me` is a part of.
+*/
+static void Sound_into_Formant_frames (Sound me, constSampled sampleGrid, Formant thee, integer fromFrame, integer toFrame,
+	integer nsamp_window, integer numberOfPoles, int which, double safetyMargin)
+{
+	const integer halfnsamp_window = nsamp_window / 2;
 
 	/* Gaussian window. */
 	autoVEC window = raw_VEC (nsamp_window);
@@ -322,9 +332,10 @@ static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer
 	integer maximumFrameLength = nsamp_window;
 	auto frameBuffer = raw_VEC (maximumFrameLength);
 	auto coefficients = raw_VEC (numberOfPoles);   // superfluous if which==2, but nobody uses that anyway
-	for (integer iframe = 1; iframe <= nFrames; iframe ++) {
-		const double t = Sampled_indexToX (thee.get(), iframe);
-		const integer leftSample = Sampled_xToLowIndex (me, t);
+	const integer sampleOffset = Sampled_xToNearestIndex (sampleGrid, my x1) - 1;
+	for (integer iframe = fromFrame; iframe <= toFrame; iframe ++) {
+		const double t = Sampled_indexToX (thee, iframe);
+		const integer leftSample = Sampled_xToLowIndex (sampleGrid, t) - sampleOffset;
 		const integer rightSample = leftSample + 1;
 		integer startSample = rightSample - halfnsamp_window;
 		integer endSample = leftSample + halfnsamp_window;
@@ -358,8 +369,25 @@ static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer
 				);
 			}
 		}
-		Melder_progress ((double) iframe / (double) nFrames, U"Formant analysis: frame ", iframe);
+		Melder_progress ((double) iframe / (double) thy nx, U"Formant analysis: frame ", iframe);
 	}
+}
+
+static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer numberOfPoles,
+	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
+{
+	const double dt = ( dt_in > 0.0 ? dt_in : halfdt_window / 4.0 );
+	integer nFrames, nsamp_window;
+	double t1;
+	getFrameGrid (my nx, my dx, my x1, dt, numberOfPoles, halfdt_window, & nFrames, & t1, & nsamp_window);
+	autoFormant thee = Formant_create (my xmin, my xmax, nFrames, dt, t1, (numberOfPoles + 1) / 2);   // e.g. 11 poles -> maximally 6 formants
+
+	autoMelderProgress progress (U"Formant analysis...");
+
+	/* Pre-emphasis. */
+	Sound_preEmphasize_inplace (me, preemphasisFrequency);
+
+	Sound_into_Formant_frames (me, me, thee.get(), 1, nFrames, nsamp_window, numberOfPoles, which, safetyMargin);
 	Formant_sort (thee.get());
 	return thee;
 }
@@ -401,4 +429,79 @@ autoFormant Sound_to_Formant_willems (Sound me, double dt, double nFormants, dou
 	}
 }
 
+autoFormant LongSound_to_Formant_burg (LongSound me, double dt, double nFormants, double maximumFrequency,
+	double halfdt_window, double preemphasisFrequency)
+{
+	try {
+		const integer numberOfPoles = Melder_iround (2.0 * nFormants);
+		if (my nx * my dx <= 2.0 * halfdt_window) {
+			autoSound sound = LongSound_extractSamples (me, 1, my nx);
+			return Sound_to_Formant_burg (sound.get(), dt, nFormants, maximumFrequency, halfdt_window, preemphasisFrequency);
+		}
+		if (dt <= 0.0)
+			dt = halfdt_window / 4.0;
+		/*
+			The samples of the whole sound after resampling, as in Sound_to_Formant_any () and Sound_resample ().
+		*/
+		const double nyquist = 0.5 / my dx;
+		const bool weHaveToResample = ! (maximumFrequency <= 0.0 || fabs (maximumFrequency / nyquist - 1) < 1.0e-12);
+		integer resampledNx = my nx;
+		double resampledDx = my dx, resampledX1 = my x1;
+		if (weHaveToResample) {
+			const double samplingFrequency = 2.0 * maximumFrequency;
+			const double upfactor = samplingFrequency * my dx;
+			if (fabs (upfactor - 2.0) < 1e-6) {
+				resampledNx = 2 * my nx;
+				resampledDx = 0.5 * my dx;
+				resampledX1 = my x1 - 0.5 * (my dx - resampledDx);
+			} else if (fabs (upfactor - 1.0) >= 1e-6) {
+				resampledNx = Melder_iround ((my xmax - my xmin) * samplingFrequency);
+				resampledDx = 1.0 / samplingFrequency;
+				resampledX1 = 0.5 * (my xmin + my xmax - (resampledNx - 1) / samplingFrequency);
+			}
+		}
+		integer numberOfFrames, nsamp_window;
+		double t1;
+		getFrameGrid (resampledNx, resampledDx, resampledX1, dt, numberOfPoles, halfdt_window, & numberOfFrames, & t1, & nsamp_window);
+		autoFormant thee = Formant_create (my xmin, my xmax, numberOfFrames, dt, t1, (numberOfPoles + 1) / 2);
+		autoSampled resampledGrid = Thing_new (Sampled);
+		Sampled_init (resampledGrid.get(), my xmin, my xmax, resampledNx, resampledDx, resampledX1);
+		/*
+			The margin has to contain half a window plus the reach of the resampling filter (50 sinc lobes);
+			the FFT-based resampling paths are not strictly local, so we add a bit more.
+		*/
+		const double margin = halfdt_window + 52.0 * std::max (my dx, resampledDx) + 0.1;
+		autoMelderProgress progress (U"LongSound: formant analysis...");
+		LongSound_analyseInBlocks (me, thee.get(), margin,
+			[&] (Sound block, integer fromFrame, integer toFrame) {
+				autoSound resampled;
+				Sound sound = block;
+				if (weHaveToResample) {
+					/*
+						Make the time domain of the block start and end at sample edges of the whole resampled sound,
+						so that the resampled block has its samples at the same times as the whole resampled sound;
+						at the edges of the whole sound, the block includes the resampled samples that lie partly outside the sound.
+					*/
+					const integer firstSample = Sampled_xToNearestIndex (me, block -> x1);
+					const integer lastSample = firstSample + block -> nx - 1;
+					const integer firstResampledSample = ( firstSample == 1 ? 1 :
+							Melder_iceiling ((block -> xmin - resampledX1) / resampledDx + 1.5) );
+					const integer lastResampledSample = ( lastSample == my nx ? resampledNx :
+							Melder_ifloor ((block -> xmax - resampledX1) / resampledDx + 0.5) );
+					block -> xmin = resampledX1 + (firstResampledSample - 1.5) * resampledDx;
+					block -> xmax = resampledX1 + (lastResampledSample - 0.5) * resampledDx;
+					resampled = Sound_resample (block, 2.0 * maximumFrequency, 50);
+					sound = resampled.get();
+				}
+				Sound_preEmphasize_inplace (sound, preemphasisFrequency);
+				Sound_into_Formant_frames (sound, resampledGrid.get(), thee.get(), fromFrame, toFrame, nsamp_window, numberOfPoles, 1, 50.0);
+			}
+		);
+		Formant_sort (thee.get());
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": formant analysis (Burg) not performed.");
+	}
+}
+
 /* End of file Sound_to_Formant.cpp */
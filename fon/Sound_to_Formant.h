@@ -16,7 +16,7 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "Sound.h"
+#include "LongSound.h"
 #include "Formant.h"
 
 autoFormant Sound_to_Formant_any (Sound me, double timeStep, integer numberOfPoles, double maximumFrequency,
@@ -30,6 +30,16 @@ autoFormant Sound_to_Formant_burg (Sound me, double timeStep, double maximumNumb
 	double maximumFormantFrequency, double windowLength, double preemphasisFrequency);
 /* Throws away all formants below 50 Hz and above Nyquist minus 50 Hz. */
 
+autoFormant LongSound_to_Formant_burg (LongSound me, double timeStep, double maximumNumberOfFormants,
+	double maximumFormantFrequency, double windowLength, double preemphasisFrequency);
+/*
+	The same as Sound_to_Formant_burg, but reads the sound in blocks,
+	so that the memory use does not depend on the duration of the LongSound.
+	Without resampling, the result is identical to that of Sound_to_Formant_burg on the whole sound;
+	if the sound has to be resampled, each block is resampled separately,
+	so that the formants can differ from those of the whole sound by rounding errors.
+*/
+
 autoFormant Sound_to_Formant_keepAll (Sound me, double timeStep, double maximumNumberOfFormants,
 	double maximumFormantFrequency, double windowLength, double preemphasisFrequency);
 /* Same as previous, but keeps all formants. Good for resynthesis. */
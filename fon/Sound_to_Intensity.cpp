@@ -32,94 +32,139 @@
  */
 
 #include "Sound_to_Intensity.h"
+#include "MelderThread.h"
 
-static autoIntensity Sound_to_Intensity_ (Sound me, double pitchFloor, double timeStep, bool subtractMeanPressure) {
+/*
+	The window duration and default time step, shared by the Sound and LongSound versions.
+*/
+static void getWindowDurationAndTimeStep (double pitchFloor, double *inout_timeStep, double *out_physicalWindowDuration) {
+	Melder_require (isdefined (pitchFloor),
+		U"The pitch floor is undefined.");
+	Melder_require (isdefined (*inout_timeStep),
+		U"The time step is undefined.");
+	Melder_require (*inout_timeStep >= 0.0,
+		U"The time step should be zero (= automatic) or positive, instead of ", *inout_timeStep, U" seconds.");
+	Melder_require (pitchFloor > 0.0,
+		U"The pitch floor should be positive, instead of ", pitchFloor, U" Hz.");
+	constexpr double minimumNumberOfPeriodsNeededForReliablePitchMeasurement = 3.2;
+	const double periodCeiling = 1.0 / pitchFloor;
+	const double logicalWindowDuration = minimumNumberOfPeriodsNeededForReliablePitchMeasurement * periodCeiling;   // == 3.2 / pitchFloor
+	if (*inout_timeStep == 0.0) {
+		constexpr double defaultOversampling = 4.0;
+		*inout_timeStep = logicalWindowDuration / defaultOversampling;   // == 0.8 / pitchFloor
+	}
+	*out_physicalWindowDuration = 2.0 * logicalWindowDuration;   // == 6.4 / pitchFloor
+	Melder_assert (*out_physicalWindowDuration > 0.0);
+}
+
+static autoIntensity Intensity_createForAnalysis (constSampled me, double pitchFloor, double timeStep, double physicalWindowDuration) {
+	integer numberOfFrames;
+	double thyFirstTime;
 	try {
-		/*
-			Preconditions.
-		*/
-		Melder_require (isdefined (pitchFloor),
-			U"The pitch floor is undefined.");
-		Melder_require (isdefined (timeStep),
-			U"The time step is undefined.");
-		Melder_require (timeStep >= 0.0,
-			U"The time step should be zero (= automatic) or positive, instead of ", timeStep, U" seconds.");
-		Melder_require (my dx > 0.0,
-			U"The Sound's time step should be positive, instead of ", my dx, U" seconds.");
-		Melder_require (pitchFloor > 0.0,
-			U"The pitch floor should be positive, instead of ", pitchFloor, U" Hz.");
-		/*
-			Defaults.
-		*/
-		constexpr double minimumNumberOfPeriodsNeededForReliablePitchMeasurement = 3.2;
-		const double periodCeiling = 1.0 / pitchFloor;
-		const double logicalWindowDuration = minimumNumberOfPeriodsNeededForReliablePitchMeasurement * periodCeiling;   // == 3.2 / pitchFloor
-		if (timeStep == 0.0) {
-			constexpr double defaultOversampling = 4.0;
-			timeStep = logicalWindowDuration / defaultOversampling;   // == 0.8 / pitchFloor
-		}
+		Sampled_shortTermAnalysis (me, physicalWindowDuration, timeStep, & numberOfFrames, & thyFirstTime);
+	} catch (MelderError) {
+		const double physicalSoundDuration = my nx * my dx;
+		Melder_throw (U"The physical duration of the sound (the number of samples times the sampling period) in an intensity analysis "
+			"should be at least 6.4 divided by the pitch floor (", pitchFloor, U" Hz), "
+			U"i.e. at least ", physicalWindowDuration, U" s, instead of ", physicalSoundDuration, U" s.");
+	}
+	return Intensity_create (my xmin, my xmax, numberOfFrames, timeStep, thyFirstTime);
+}
 
-		const double physicalWindowDuration = 2.0 * logicalWindowDuration;   // == 6.4 / pitchFloor
-		Melder_assert (physicalWindowDuration > 0.0);
-		const double halfWindowDuration = 0.5 * physicalWindowDuration;
-		const integer halfWindowSamples = Melder_ifloor (halfWindowDuration / my dx);
-		const integer windowNumberOfSamples = 2 * halfWindowSamples + 1;
-		autoVEC amplitude = zero_VEC (windowNumberOfSamples);
-		autoVEC window = zero_VEC (windowNumberOfSamples);
-		const integer windowCentreSampleNumber = halfWindowSamples + 1;
+/*
+	Computes the frames fromFrame .. toFrame of `thee`, whose time grid need not have been computed from `me`,
+	as long as `me` contains the samples around those frames.
+	The centre samples are computed on `sampleGrid`, which is either `me` or the LongSound that `me` was read from.
 
-		for (integer i = 1; i <= windowNumberOfSamples; i ++) {
-			const double x = (i - windowCentreSampleNumber) * my dx / halfWindowDuration;
-			const double root = sqrt (Melder_clippedLeft (0.0, 1.0 - sqr (x)));   // clipping should be rare
-			window [i] = NUMbessel_i0_f ((2.0 * NUMpi * NUMpi + 0.5) * root);
-		}
+	The window sums are taken directly from the samples of `me`, in a single pass per frame and channel.
+	To subtract the mean pressure in that same pass, the sums are taken relative to the centre sample `r`:
+		sum (x - mean)^2 w = sum (x - r)^2 w - 2 (mean - r) sum (x - r) w + (mean - r)^2 sum w
+	Because `r` is a sample within the window, and therefore never far from the mean
+	compared to the spread of the samples, this loses no precision, even for a sound with a large DC offset.
+	The frames are independent and are computed in parallel;
+	as every frame is computed in the same way by any thread, the result does not depend on the number of threads.
+*/
+static void Sound_into_Intensity_frames (Sound me, constSampled sampleGrid, Intensity thee, integer fromFrame, integer toFrame,
+	double physicalWindowDuration, bool subtractMeanPressure)
+{
+	const double halfWindowDuration = 0.5 * physicalWindowDuration;
+	const integer halfWindowSamples = Melder_ifloor (halfWindowDuration / my dx);
+	const integer windowNumberOfSamples = 2 * halfWindowSamples + 1;
+	autoVEC window = zero_VEC (windowNumberOfSamples);
+	const integer windowCentreSampleNumber = halfWindowSamples + 1;
 
-		integer numberOfFrames;
-		double thyFirstTime;
-		try {
-			Sampled_shortTermAnalysis (me, physicalWindowDuration, timeStep, & numberOfFrames, & thyFirstTime);
-		} catch (MelderError) {
-			const double physicalSoundDuration = my nx * my dx;
-			Melder_throw (U"The physical duration of the sound (the number of samples times the sampling period) in an intensity analysis "
-				"should be at least 6.4 divided by the pitch floor (", pitchFloor, U" Hz), "
-				U"i.e. at least ", physicalWindowDuration, U" s, instead of ", physicalSoundDuration, U" s.");
-		}
-		autoIntensity thee = Intensity_create (my xmin, my xmax, numberOfFrames, timeStep, thyFirstTime);
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double midTime = Sampled_indexToX (thee.get(), iframe);
-			const integer soundCentreSampleNumber = Sampled_xToNearestIndex (me, midTime);   // time accuracy is half a sampling period
+	for (integer i = 1; i <= windowNumberOfSamples; i ++) {
+		const double x = (i - windowCentreSampleNumber) * my dx / halfWindowDuration;
+		const double root = sqrt (Melder_clippedLeft (0.0, 1.0 - sqr (x)));   // clipping should be rare
+		window [i] = NUMbessel_i0_f ((2.0 * NUMpi * NUMpi + 0.5) * root);
+	}
 
-			integer leftSample = soundCentreSampleNumber - halfWindowSamples;
-			integer rightSample = soundCentreSampleNumber + halfWindowSamples;
-			/*
-				Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
-			*/
-			Melder_clipLeft (1_integer, & leftSample);
-			Melder_clipRight (& rightSample, my nx);
-			Melder_require (rightSample >= leftSample,
-				U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
+	const integer sampleOffset = Sampled_xToNearestIndex (sampleGrid, my x1) - 1;
+	const integer numberOfFrames = toFrame - fromFrame + 1;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 20);
+	MelderThread_runChunked (numberOfThreads, numberOfFrames, 0,
+		[&] (integer /* ithread */, integer fromElement, integer toElement) {
+			for (integer iframe = fromFrame + fromElement - 1; iframe <= fromFrame + toElement - 1; iframe ++) {
+				const double midTime = Sampled_indexToX (thee, iframe);
+				const integer soundCentreSampleNumber = Sampled_xToNearestIndex (sampleGrid, midTime) - sampleOffset;   // time accuracy is half a sampling period
 
-			const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
-			VEC amplitudePart = amplitude.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			constVEC windowPart = window.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			longdouble sumxw = 0.0, sumw = 0.0;
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				amplitudePart  <<=  my z [ichan].part (leftSample, rightSample);
-				if (subtractMeanPressure)
-					centre_VEC_inout (amplitudePart);
-				for (integer isamp = 1; isamp <= amplitudePart.size; isamp ++) {
-					sumxw += sqr (amplitudePart [isamp]) * windowPart [isamp];
-					sumw += windowPart [isamp];
+				integer leftSample = soundCentreSampleNumber - halfWindowSamples;
+				integer rightSample = soundCentreSampleNumber + halfWindowSamples;
+				/*
+					Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
+				*/
+				Melder_clipLeft (1_integer, & leftSample);
+				Melder_clipRight (& rightSample, my nx);
+				Melder_require (rightSample >= leftSample,
+					U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
+
+				const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
+				const integer numberOfSamples = rightSample - leftSample + 1;
+				const double *w = & window [windowFromSoundOffset + leftSample];
+				double sumw = 0.0;
+				for (integer isamp = 0; isamp < numberOfSamples; isamp ++)
+					sumw += w [isamp];
+				double sumxw = 0.0;
+				for (integer ichan = 1; ichan <= my ny; ichan ++) {
+					const double *x = & my z [ichan] [leftSample];
+					if (subtractMeanPressure) {
+						const double reference = x [Melder_clipped (0_integer, soundCentreSampleNumber - leftSample, numberOfSamples - 1)];
+						double sumd = 0.0, sumdw = 0.0, sumddw = 0.0;
+						for (integer isamp = 0; isamp < numberOfSamples; isamp ++) {
+							const double d = x [isamp] - reference, dw = d * w [isamp];
+							sumd += d;
+							sumdw += dw;
+							sumddw += d * dw;
+						}
+						const double meanMinusReference = sumd / numberOfSamples;
+						sumxw += sumddw - meanMinusReference * (2.0 * sumdw - meanMinusReference * sumw);
+					} else {
+						double sumxxw = 0.0;
+						for (integer isamp = 0; isamp < numberOfSamples; isamp ++)
+							sumxxw += sqr (x [isamp]) * w [isamp];
+						sumxw += sumxxw;
+					}
 				}
+				const double intensity_in_Pa2 = sumxw / (my ny * sumw);
+				constexpr double hearingThreshold_in_Pa = 2.0e-5;
+				constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
+				const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
+				const double intensity_in_dB_re_hearingThreshold = ( intensity_re_hearingThreshold < 1.0e-30 ? -300.0 :
+						10.0 * log10 (intensity_re_hearingThreshold) );
+				thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold;
 			}
-			const double intensity_in_Pa2 = double (sumxw / sumw);
-			constexpr double hearingThreshold_in_Pa = 2.0e-5;
-			constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
-			const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
-			const double intensity_in_dB_re_hearingThreshold = ( intensity_re_hearingThreshold < 1.0e-30 ? -300.0 :
-					10.0 * log10 (intensity_re_hearingThreshold) );
-			thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold;
 		}
+	);
+}
+
+static autoIntensity Sound_to_Intensity_ (Sound me, double pitchFloor, double timeStep, bool subtractMeanPressure) {
+	try {
+		Melder_require (my dx > 0.0,
+			U"The Sound's time step should be positive, instead of ", my dx, U" seconds.");
+		double physicalWindowDuration;
+		getWindowDurationAndTimeStep (pitchFloor, & timeStep, & physicalWindowDuration);
+		autoIntensity thee = Intensity_createForAnalysis (me, pitchFloor, timeStep, physicalWindowDuration);
+		Sound_into_Intensity_frames (me, me, thee.get(), 1, thy nx, physicalWindowDuration, subtractMeanPressure);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": intensity analysis not performed.");
@@ -136,6 +181,23 @@ autoIntensity Sound_to_Intensity (Sound me, double pitchFloor, double timeStep,
 	}
 }
 
+autoIntensity LongSound_to_Intensity (LongSound me, double pitchFloor, double timeStep, bool subtractMeanPressure) {
+	try {
+		double physicalWindowDuration;
+		getWindowDurationAndTimeStep (pitchFloor, & timeStep, & physicalWindowDuration);
+		autoIntensity thee = Intensity_createForAnalysis (me, pitchFloor, timeStep, physicalWindowDuration);
+		autoMelderProgress progress (U"LongSound: intensity analysis...");
+		LongSound_analyseInBlocks (me, thee.get(), 0.5 * physicalWindowDuration + 2.0 * my dx,
+			[&] (Sound block, integer fromFrame, integer toFrame) {
+				Sound_into_Intensity_frames (block, me, thee.get(), fromFrame, toFrame, physicalWindowDuration, subtractMeanPressure);
+			}
+		);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": intensity analysis not performed.");
+	}
+}
+
 autoIntensityTier Sound_to_IntensityTier (Sound me, double pitchFloor, double timeStep, bool subtractMean) {
 	try {
 		autoIntensity intensity = Sound_to_Intensity (me, pitchFloor, timeStep, subtractMean);
@@ -35,6 +35,8 @@
 #include "Sound_to_Pitch.h"
 #include "NUM2.h"
 #include "MelderThread.h"
+#include "Preferences.h"
+#include <atomic>
 #include "Sound_and_Spectrum.h"
 
 #define AC_HANNING  0
@@ -42,15 +44,15 @@
 #define FCC_NORMAL  2
 #define FCC_ACCURATE  3
 
-static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
+static void Sound_into_PitchFrame (Sound me, constSampled sampleGrid, integer sampleOffset, Pitch_Frame pitchFrame, double t,
 	double pitchFloor, int maxnCandidates, int method, double voicingThreshold, double octaveCost,
 	NUMfft_Table fftTable, double dt_window, integer nsamp_window, integer halfnsamp_window,
 	integer maximumLag, integer nsampFFT, integer nsamp_period, integer halfnsamp_period,
 	integer brent_ixmax, integer brent_depth, double globalPeak,
 	MAT const& frame, VEC const& ac, VEC const& window, VEC const& windowR,
-	double *r, INTVEC const& imax, VEC const& localMean)
+	double *r, INTVEC const& imax, VEC const& localMean, bool crossCorrelationViaFFT, MAT const& crossSpectra)
 {
-	integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
+	integer leftSample = Sampled_xToLowIndex (sampleGrid, t) - sampleOffset, rightSample = leftSample + 1;
 	integer startSample, endSample;
 
 	for (integer channel = 1; channel <= my ny; channel ++) {
@@ -108,7 +110,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 	if (method >= FCC_NORMAL) {
 		const double startTime = t - 0.5 * (1.0 / pitchFloor + dt_window);
 		integer localSpan = maximumLag + nsamp_window;
-		if ((startSample = Sampled_xToLowIndex (me, startTime)) < 1)
+		if ((startSample = Sampled_xToLowIndex (sampleGrid, startTime) - sampleOffset) < 1)
 			startSample = 1;
 		if (localSpan > my nx + 1 - startSample)
 			localSpan = my nx + 1 - startSample;
@@ -124,20 +126,60 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		}
 		longdouble sumy2 = sumx2;   // at zero lag, these are still equal
 		r [0] = 1.0;
-		for (integer i = 1; i <= localMaximumLag; i ++) {
-			longdouble product = 0.0;
+		if (crossCorrelationViaFFT) {
+			/*
+				The cross-correlation of the window x with the stretch y = amp [1 .. localSpan]
+				is the inverse FFT of conj (X) * Y, summed over the channels.
+				Because fftTable -> n >= localSpan and we need only lags up to localSpan - nsamp_window,
+				the circularity of the FFT does no harm.
+			*/
+			const integer nsampFFT_cc = fftTable -> n;
+			ac  <<=  0.0;
 			for (integer channel = 1; channel <= my ny; channel ++) {
 				const double * const amp = & my z [channel] [0] + offset;
-				const double y0 = amp [i] - localMean [channel];
-				const double yZ = amp [i + nsamp_window] - localMean [channel];
-				sumy2 += yZ * yZ - y0 * y0;
-				for (integer j = 1; j <= nsamp_window; j ++) {
-					const double x = amp [j] - localMean [channel];
-					const double y = amp [i + j] - localMean [channel];
-					product += x * y;
+				VEC x = crossSpectra.row (1), y = crossSpectra.row (2);
+				for (integer i = 1; i <= nsamp_window; i ++)
+					x [i] = amp [i] - localMean [channel];
+				x.part (nsamp_window + 1, nsampFFT_cc)  <<=  0.0;
+				for (integer i = 1; i <= localSpan; i ++)
+					y [i] = amp [i] - localMean [channel];
+				y.part (localSpan + 1, nsampFFT_cc)  <<=  0.0;
+				NUMfft_forward (fftTable, x);
+				NUMfft_forward (fftTable, y);
+				ac [1] += x [1] * y [1];   // DC component
+				for (integer i = 2; i < nsampFFT_cc; i += 2) {
+					ac [i] += x [i] * y [i] + x [i + 1] * y [i + 1];
+					ac [i + 1] += x [i] * y [i + 1] - x [i + 1] * y [i];
 				}
+				ac [nsampFFT_cc] += x [nsampFFT_cc] * y [nsampFFT_cc];   // Nyquist frequency
+			}
+			NUMfft_backward (fftTable, ac);   // cross-correlation, times nsampFFT_cc
+			for (integer i = 1; i <= localMaximumLag; i ++) {
+				for (integer channel = 1; channel <= my ny; channel ++) {
+					const double * const amp = & my z [channel] [0] + offset;
+					const double y0 = amp [i] - localMean [channel];
+					const double yZ = amp [i + nsamp_window] - localMean [channel];
+					sumy2 += yZ * yZ - y0 * y0;
+				}
+				const double product = ac [i + 1] / nsampFFT_cc;
+				r [- i] = r [i] = product / sqrt ((double) sumx2 * (double) sumy2);
+			}
+		} else {
+			for (integer i = 1; i <= localMaximumLag; i ++) {
+				longdouble product = 0.0;
+				for (integer channel = 1; channel <= my ny; channel ++) {
+					const double * const amp = & my z [channel] [0] + offset;
+					const double y0 = amp [i] - localMean [channel];
+					const double yZ = amp [i + nsamp_window] - localMean [channel];
+					sumy2 += yZ * yZ - y0 * y0;
+					for (integer j = 1; j <= nsamp_window; j ++) {
+						const double x = amp [j] - localMean [channel];
+						const double y = amp [i + j] - localMean [channel];
+						product += x * y;
+					}
+				}
+				r [- i] = r [i] = (double) product / sqrt ((double) sumx2 * (double) sumy2);
 			}
-			r [- i] = r [i] = (double) product / sqrt ((double) sumx2 * (double) sumy2);
 		}
 	} else {
 
@@ -261,6 +303,8 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 
 Thing_define (Sound_into_Pitch_Args, Thing) { public:
 	Sound sound;
+	constSampled sampleGrid;
+	integer sampleOffset;
 	Pitch pitch;
 	integer firstFrame, lastFrame;
 	double pitchFloor;
@@ -271,8 +315,10 @@ Thing_define (Sound_into_Pitch_Args, Thing) { public:
 	VEC window, windowR;
 	bool isMainThread;
 	volatile int *cancelled;
+	std::atomic <integer> *numberOfFramesDone;
+	bool crossCorrelationViaFFT;
 	autoNUMfft_Table fftTable;
-	autoMAT frame;
+	autoMAT frame, crossSpectra;
 	autoVEC ac, rbuffer, localMean;
 	double *r;
 	autoINTVEC imax;
@@ -287,8 +333,8 @@ static void Sound_into_Pitch (Sound_into_Pitch_Args me)
 		const double t = Sampled_indexToX (my pitch, iframe);
 		if (my isMainThread) {
 			try {
-				Melder_progress (0.1 + 0.8 * (iframe - my firstFrame) / (my lastFrame - my firstFrame),
-					U"Sound to Pitch: analysing ", my lastFrame, U" frames");
+				Melder_progress (0.1 + 0.8 * double (*my numberOfFramesDone) / my pitch -> nx,
+					U"Sound to Pitch: analysing ", my pitch -> nx, U" frames");
 			} catch (MelderError) {
 				*my cancelled = 1;
 				throw;
@@ -296,120 +342,286 @@ static void Sound_into_Pitch (Sound_into_Pitch_Args me)
 		} else if (*my cancelled) {
 			return;
 		}
-		Sound_into_PitchFrame (my sound, pitchFrame, t,
+		Sound_into_PitchFrame (my sound, my sampleGrid, my sampleOffset, pitchFrame, t,
 			my pitchFloor, my maxnCandidates, my method, my voicingThreshold, my octaveCost,
 			& my fftTable, my dt_window, my nsamp_window, my halfnsamp_window,
 			my maximumLag, my nsampFFT, my nsamp_period, my halfnsamp_period,
 			my brent_ixmax, my brent_depth, my globalPeak,
 			my frame.get(), my ac.get(), my window, my windowR,
-			my r, my imax.get(), my localMean.get()
+			my r, my imax.get(), my localMean.get(), my crossCorrelationViaFFT, my crossSpectra.get()
 		);
+		++ *my numberOfFramesDone;
 	}
 }
 
-autoPitch Sound_to_Pitch_any (Sound me,
-	int method, double periodsPerWindow,
-	double dt, double pitchFloor, double pitchCeiling,
-	integer maxnCandidates,
-	double silenceThreshold, double voicingThreshold,
-	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost)
+/*
+	The parts of the analysis that depend on the whole sound (the frame grid and the global peak)
+	are computed separately from the analysis of the frames,
+	so that a LongSound can be analysed in blocks with exactly the same result.
+*/
+static void getMethodParameters (int method, double *inout_periodsPerWindow, integer *out_brent_depth, double *out_interpolation_depth) {
+	switch (method) {
+		case AC_HANNING:
+			*out_brent_depth = NUM_PEAK_INTERPOLATE_SINC70;
+			*out_interpolation_depth = 0.5;
+			break;
+		case AC_GAUSS:
+			*inout_periodsPerWindow *= 2;   // because Gaussian window is twice as long
+			*out_brent_depth = NUM_PEAK_INTERPOLATE_SINC700;
+			*out_interpolation_depth = 0.25;   // because Gaussian window is twice as long
+			break;
+		case FCC_NORMAL:
+			*out_brent_depth = NUM_PEAK_INTERPOLATE_SINC70;
+			*out_interpolation_depth = 1.0;
+			break;
+		case FCC_ACCURATE:
+			*out_brent_depth = NUM_PEAK_INTERPOLATE_SINC700;
+			*out_interpolation_depth = 1.0;
+			break;
+	}
+}
+
+static autoPitch Pitch_createForAnalysis (constSampled me, int method, double periodsPerWindow,
+	double dt, double pitchFloor, double *inout_pitchCeiling, integer maxnCandidates)
 {
+	volatile const double duration = my dx * my nx;   // volatile, because we need to truncate to 64 bits
+	if (pitchFloor < periodsPerWindow / duration)
+		Melder_throw (U"To analyse this Sound, “pitch floor” must not be less than ", periodsPerWindow / duration, U" Hz.");
+
+	Melder_clipRight (inout_pitchCeiling, 0.5 / my dx);
+
+	/*
+		Determine window duration in seconds and in samples.
+	*/
+	const double dt_window = periodsPerWindow / pitchFloor;
+	const integer halfnsamp_window = Melder_ifloor (dt_window / my dx) / 2 - 1;
+	if (halfnsamp_window < 2)
+		Melder_throw (U"Analysis window too short.");
+
+	/*
+	 * Determine the number of frames.
+	 * Fit as many frames as possible symmetrically in the total duration.
+	 * We do this even for the forward cross-correlation method,
+	 * because that allows us to compare the two methods.
+	 */
+	integer numberOfFrames;
+	double t1;
 	try {
-		autoNUMfft_Table fftTable;
-		double t1;
-		integer numberOfFrames;
-		integer nsampFFT;
-		double interpolation_depth;
-		integer brent_ixmax, brent_depth;
-		double globalPeak;
+		Sampled_shortTermAnalysis (me, method >= FCC_NORMAL ? 1.0 / pitchFloor + dt_window : dt_window, dt, & numberOfFrames, & t1);
+	} catch (MelderError) {
+		Melder_throw (U"The pitch analysis would give zero pitch frames.");
+	}
 
-		Melder_assert (maxnCandidates >= 2);
-		Melder_assert (method >= AC_HANNING && method <= FCC_ACCURATE);
+	/*
+		Create the resulting pitch contour.
+	*/
+	autoPitch thee = Pitch_create (my xmin, my xmax, numberOfFrames, dt, t1, *inout_pitchCeiling, maxnCandidates);
 
-		if (maxnCandidates < pitchCeiling / pitchFloor)
-			maxnCandidates = Melder_ifloor (pitchCeiling / pitchFloor);
+	/*
+		Create (too much) space for candidates.
+	*/
+	for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
+		const Pitch_Frame pitchFrame = & thy frames [iframe];
+		Pitch_Frame_init (pitchFrame, maxnCandidates);
+	}
+	return thee;
+}
 
-		if (dt <= 0.0)
-			dt = periodsPerWindow / pitchFloor / 4.0;   // e.g. 3 periods, 75 Hz: 10 milliseconds
+/*
+	Computes the candidates of the frames fromFrame .. toFrame of `thee`,
+	whose time grid need not have been computed from `me`, as long as `me` contains the samples around those frames.
+	The sample numbers are computed on `sampleGrid`, which is either `me` or the LongSound that `me` was read from,
+	so that a block gives exactly the same frames as the whole sound, even where a frame lies halfway between two samples.
+*/
+static void Sound_into_Pitch_frames (Sound me, constSampled sampleGrid, Pitch thee, integer fromFrame, integer toFrame,
+	int method, double periodsPerWindow, double pitchFloor, integer maxnCandidates,
+	double voicingThreshold, double octaveCost, double globalPeak, bool crossCorrelationViaFFT)
+{
+	autoNUMfft_Table fftTable;
+	integer nsampFFT;
+	integer brent_ixmax, brent_depth;
+	double interpolation_depth;
+	getMethodParameters (method, & periodsPerWindow, & brent_depth, & interpolation_depth);
 
-		switch (method) {
-			case AC_HANNING:
-				brent_depth = NUM_PEAK_INTERPOLATE_SINC70;
-				interpolation_depth = 0.5;
-				break;
-			case AC_GAUSS:
-				periodsPerWindow *= 2;   // because Gaussian window is twice as long
-				brent_depth = NUM_PEAK_INTERPOLATE_SINC700;
-				interpolation_depth = 0.25;   // because Gaussian window is twice as long
-				break;
-			case FCC_NORMAL:
-				brent_depth = NUM_PEAK_INTERPOLATE_SINC70;
-				interpolation_depth = 1.0;
-				break;
-			case FCC_ACCURATE:
-				brent_depth = NUM_PEAK_INTERPOLATE_SINC700;
-				interpolation_depth = 1.0;
-				break;
-		}
-		volatile const double duration = my dx * my nx;   // volatile, because we need to truncate to 64 bits
-		if (pitchFloor < periodsPerWindow / duration)
-			Melder_throw (U"To analyse this Sound, “pitch floor” must not be less than ", periodsPerWindow / duration, U" Hz.");
+	/*
+		Determine the number of samples in the longest period.
+		We need this to compute the local mean of the sound (looking one period in both directions),
+		and to compute the local peak of the sound (looking half a period in both directions).
+	*/
+	const integer nsamp_period = Melder_ifloor (1.0 / my dx / pitchFloor);
+	const integer halfnsamp_period = nsamp_period / 2 + 1;
 
-		/*
-			Determine the number of samples in the longest period.
-			We need this to compute the local mean of the sound (looking one period in both directions),
-			and to compute the local peak of the sound (looking half a period in both directions).
-		*/
-		const integer nsamp_period = Melder_ifloor (1.0 / my dx / pitchFloor);
-		const integer halfnsamp_period = nsamp_period / 2 + 1;
+	/*
+		Determine window duration in seconds and in samples.
+	*/
+	const double dt_window = periodsPerWindow / pitchFloor;
+	integer nsamp_window = Melder_ifloor (dt_window / my dx);
+	const integer halfnsamp_window = nsamp_window / 2 - 1;
+	Melder_assert (halfnsamp_window >= 2);   // checked in Pitch_createForAnalysis ()
+	nsamp_window = halfnsamp_window * 2;
+
+	/*
+	 * Determine the maximum lag.
+	 */
+	const integer maximumLag = std::min (Melder_ifloor (nsamp_window / periodsPerWindow) + 2, nsamp_window);
+
+	autoVEC window, windowR;
+	if (method >= FCC_NORMAL) {   // for cross-correlation analysis
+
+		nsampFFT = 0;
+		brent_ixmax = Melder_ifloor (nsamp_window * interpolation_depth);
 
-		Melder_clipRight (& pitchCeiling, 0.5 / my dx);
+	} else {   // for autocorrelation analysis
 
 		/*
-			Determine window duration in seconds and in samples.
+			Compute the number of samples needed for doing FFT.
+			To avoid edge effects, we have to append zeroes to the window.
+			The maximum lag considered for maxima is maximumLag.
+			The maximum lag used in interpolation is nsamp_window * interpolation_depth.
 		*/
-		const double dt_window = periodsPerWindow / pitchFloor;
-		integer nsamp_window = Melder_ifloor (dt_window / my dx);
-		const integer halfnsamp_window = nsamp_window / 2 - 1;
-		if (halfnsamp_window < 2)
-			Melder_throw (U"Analysis window too short.");
-		nsamp_window = halfnsamp_window * 2;
+		nsampFFT = 1;
+		while (nsampFFT < nsamp_window * (1 + interpolation_depth))
+			nsampFFT *= 2;
 
 		/*
-		 * Determine the minimum and maximum lags.
-		 */
-		const integer minimumLag = std::max (2_integer, Melder_ifloor (1.0 / my dx / pitchCeiling));
-		const integer maximumLag = std::min (Melder_ifloor (nsamp_window / periodsPerWindow) + 2, nsamp_window);
+			Create buffers for autocorrelation analysis.
+		*/
+		windowR. resize (nsampFFT);
+		window. resize (nsamp_window);
+		NUMfft_Table_init (& fftTable, nsampFFT);
 
 		/*
-		 * Determine the number of frames.
-		 * Fit as many frames as possible symmetrically in the total duration.
-		 * We do this even for the forward cross-correlation method,
-		 * because that allows us to compare the two methods.
-		 */
-		try {
-			Sampled_shortTermAnalysis (me, method >= FCC_NORMAL ? 1.0 / pitchFloor + dt_window : dt_window, dt, & numberOfFrames, & t1);
-		} catch (MelderError) {
-			Melder_throw (U"The pitch analysis would give zero pitch frames.");
+			A Gaussian or Hanning window is applied against phase effects.
+			The Hanning window is 2 to 5 dB better for 3 periods/window.
+			The Gaussian window is 25 to 29 dB better for 6 periods/window.
+		*/
+		if (method == AC_GAUSS) {   // Gaussian window
+			double imid = 0.5 * (nsamp_window + 1), edge = exp (-12.0);
+			for (integer i = 1; i <= nsamp_window; i ++)
+				window [i] = (exp (-48.0 * (i - imid) * (i - imid) /
+						(nsamp_window + 1) / (nsamp_window + 1)) - edge) / (1.0 - edge);
+		} else {   // Hanning window
+			for (integer i = 1; i <= nsamp_window; i ++)
+				window [i] = 0.5 - 0.5 * cos (i * 2 * NUMpi / (nsamp_window + 1));
 		}
 
 		/*
-			Create the resulting pitch contour.
+			Compute the normalized autocorrelation of the window.
 		*/
-		autoPitch thee = Pitch_create (my xmin, my xmax, numberOfFrames, dt, t1, pitchCeiling, maxnCandidates);
+		for (integer i = 1; i <= nsamp_window; i ++)
+			windowR [i] = window [i];
+		NUMfft_forward (& fftTable, windowR.get());
+		windowR [1] *= windowR [1];   // DC component
+		for (integer i = 2; i < nsampFFT; i += 2) {
+			windowR [i] = windowR [i] * windowR [i] + windowR [i + 1] * windowR [i + 1];
+			windowR [i + 1] = 0.0;   // power spectrum: square and zero
+		}
+		windowR [nsampFFT] *= windowR [nsampFFT];   // Nyquist frequency
+		NUMfft_backward (& fftTable, windowR.get());   // autocorrelation
+		for (integer i = 2; i <= nsamp_window; i ++)
+			windowR [i] /= windowR [1];   // normalize
+		windowR [1] = 1.0;   // normalize
 
-		/*
-			Create (too much) space for candidates.
-		*/
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const Pitch_Frame pitchFrame = & thy frames [iframe];
-			Pitch_Frame_init (pitchFrame, maxnCandidates);
+		brent_ixmax = Melder_ifloor (nsamp_window * interpolation_depth);
+	}
+
+	const integer sampleOffset = Sampled_xToNearestIndex (sampleGrid, my x1) - 1;
+	const integer numberOfFrames = toFrame - fromFrame + 1;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 20);
+	trace (MelderThread_getNumberOfProcessors (), U" processors, ", numberOfThreads, U" threads");
+
+	/*
+		Each thread gets its own workspace; the frames are handed out in chunks.
+	*/
+	OrderedOf <structSound_into_Pitch_Args> args;
+	volatile int cancelled = 0;
+	std::atomic <integer> numberOfFramesDone (fromFrame - 1);
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		autoSound_into_Pitch_Args arg = Thing_new (Sound_into_Pitch_Args);
+		arg -> sound = me;
+		arg -> sampleGrid = sampleGrid;
+		arg -> sampleOffset = sampleOffset;
+		arg -> pitch = thee;
+		arg -> pitchFloor = pitchFloor;
+		arg -> maxnCandidates = maxnCandidates;
+		arg -> method = method;
+		arg -> voicingThreshold = voicingThreshold;
+		arg -> octaveCost = octaveCost;
+		arg -> dt_window = dt_window;
+		arg -> nsamp_window = nsamp_window;
+		arg -> halfnsamp_window = halfnsamp_window;
+		arg -> maximumLag = maximumLag;
+		arg -> nsampFFT = nsampFFT;
+		arg -> nsamp_period = nsamp_period;
+		arg -> halfnsamp_period = halfnsamp_period;
+		arg -> brent_ixmax = brent_ixmax;
+		arg -> brent_depth = brent_depth;
+		arg -> globalPeak = globalPeak;
+		arg -> window = window.get();
+		arg -> windowR = windowR.get();
+		arg -> isMainThread = ( ithread == 1 );   // the calling thread, see MelderThread_runChunked
+		arg -> cancelled = & cancelled;
+		arg -> numberOfFramesDone = & numberOfFramesDone;
+		arg -> crossCorrelationViaFFT = crossCorrelationViaFFT;
+		if (method >= FCC_NORMAL) {   // cross-correlation
+			arg -> frame = zero_MAT (my ny, nsamp_window);
+			if (crossCorrelationViaFFT) {
+				integer nsampFFT_cc = 1;
+				while (nsampFFT_cc < maximumLag + nsamp_window)
+					nsampFFT_cc *= 2;
+				NUMfft_Table_init (& arg -> fftTable, nsampFFT_cc);
+				arg -> crossSpectra = zero_MAT (2, nsampFFT_cc);
+				arg -> ac = zero_VEC (nsampFFT_cc);
+			}
+		} else {   // autocorrelation
+			NUMfft_Table_init (& arg -> fftTable, nsampFFT);
+			arg -> frame = zero_MAT (my ny, nsampFFT);
+			arg -> ac = zero_VEC (nsampFFT);
+		}
+		arg -> rbuffer = zero_VEC (2 * nsamp_window + 1);
+		arg -> r = & arg -> rbuffer [1 + nsamp_window];
+		arg -> imax = zero_INTVEC (maxnCandidates);
+		arg -> localMean = zero_VEC (my ny);
+		args. addItem_move (arg.move());
+	}
+	MelderThread_runChunked (numberOfThreads, numberOfFrames, 0,
+		[&] (integer ithread, integer fromElement, integer toElement) {
+			Sound_into_Pitch_Args arg = args.at [ithread];
+			arg -> firstFrame = fromFrame - 1 + fromElement;
+			arg -> lastFrame = fromFrame - 1 + toElement;
+			Sound_into_Pitch (arg);
 		}
+	);
+}
+
+autoPitch Sound_to_Pitch_any (Sound me,
+	int method, double periodsPerWindow,
+	double dt, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
+	bool crossCorrelationViaFFT)
+{
+	try {
+		Melder_assert (maxnCandidates >= 2);
+		Melder_assert (method >= AC_HANNING && method <= FCC_ACCURATE);
+
+		if (maxnCandidates < pitchCeiling / pitchFloor)
+			maxnCandidates = Melder_ifloor (pitchCeiling / pitchFloor);
+
+		if (dt <= 0.0)
+			dt = periodsPerWindow / pitchFloor / 4.0;   // e.g. 3 periods, 75 Hz: 10 milliseconds
+
+		double effectivePeriodsPerWindow = periodsPerWindow;
+		integer brent_depth;
+		double interpolation_depth;
+		getMethodParameters (method, & effectivePeriodsPerWindow, & brent_depth, & interpolation_depth);
+		autoPitch thee = Pitch_createForAnalysis (me, method, effectivePeriodsPerWindow, dt, pitchFloor, & pitchCeiling, maxnCandidates);
 
 		/*
 			Compute the global absolute peak for determination of silence threshold.
 		*/
-		globalPeak = 0.0;
+		double globalPeak = 0.0;
 		for (integer ichan = 1; ichan <= my ny; ichan ++) {
 			const double mean = NUMmean (my z.row (ichan));
 			for (integer i = 1; i <= my nx; i ++) {
@@ -421,124 +633,86 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		if (globalPeak == 0.0)
 			return thee;
 
-		autoVEC window, windowR;
-		if (method >= FCC_NORMAL) {   // for cross-correlation analysis
+		autoMelderProgress progress (U"Sound to Pitch...");
 
-			nsampFFT = 0;
-			brent_ixmax = Melder_ifloor (nsamp_window * interpolation_depth);
+		Sound_into_Pitch_frames (me, me, thee.get(), 1, thy nx, method, periodsPerWindow, pitchFloor, maxnCandidates,
+				voicingThreshold, octaveCost, globalPeak, crossCorrelationViaFFT);
 
-		} else {   // for autocorrelation analysis
+		Melder_progress (0.95, U"Sound to Pitch: path finder");
+		Pitch_pathFinder (thee.get(), silenceThreshold, voicingThreshold,
+				octaveCost, octaveJumpCost, voicedUnvoicedCost, pitchCeiling, Melder_debug == 31 ? true : false);
 
-			/*
-				Compute the number of samples needed for doing FFT.
-				To avoid edge effects, we have to append zeroes to the window.
-				The maximum lag considered for maxima is maximumLag.
-				The maximum lag used in interpolation is nsamp_window * interpolation_depth.
-			*/
-			nsampFFT = 1;
-			while (nsampFFT < nsamp_window * (1 + interpolation_depth))
-				nsampFFT *= 2;
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": pitch analysis not performed.");
+	}
+}
 
-			/*
-				Create buffers for autocorrelation analysis.
-			*/
-			windowR. resize (nsampFFT);
-			window. resize (nsamp_window);
-			NUMfft_Table_init (& fftTable, nsampFFT);
+autoPitch LongSound_to_Pitch_any (LongSound me,
+	int method, double periodsPerWindow,
+	double dt, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
+	bool crossCorrelationViaFFT)
+{
+	try {
+		Melder_assert (maxnCandidates >= 2);
+		Melder_assert (method >= AC_HANNING && method <= FCC_ACCURATE);
 
-			/*
-				A Gaussian or Hanning window is applied against phase effects.
-				The Hanning window is 2 to 5 dB better for 3 periods/window.
-				The Gaussian window is 25 to 29 dB better for 6 periods/window.
-			*/
-			if (method == AC_GAUSS) {   // Gaussian window
-				double imid = 0.5 * (nsamp_window + 1), edge = exp (-12.0);
-				for (integer i = 1; i <= nsamp_window; i ++)
-					window [i] = (exp (-48.0 * (i - imid) * (i - imid) /
-							(nsamp_window + 1) / (nsamp_window + 1)) - edge) / (1.0 - edge);
-			} else {   // Hanning window
-				for (integer i = 1; i <= nsamp_window; i ++)
-					window [i] = 0.5 - 0.5 * cos (i * 2 * NUMpi / (nsamp_window + 1));
-			}
+		if (maxnCandidates < pitchCeiling / pitchFloor)
+			maxnCandidates = Melder_ifloor (pitchCeiling / pitchFloor);
 
-			/*
-				Compute the normalized autocorrelation of the window.
-			*/
-			for (integer i = 1; i <= nsamp_window; i ++)
-				windowR [i] = window [i];
-			NUMfft_forward (& fftTable, windowR.get());
-			windowR [1] *= windowR [1];   // DC component
-			for (integer i = 2; i < nsampFFT; i += 2) {
-				windowR [i] = windowR [i] * windowR [i] + windowR [i + 1] * windowR [i + 1];
-				windowR [i + 1] = 0.0;   // power spectrum: square and zero
-			}
-			windowR [nsampFFT] *= windowR [nsampFFT];   // Nyquist frequency
-			NUMfft_backward (& fftTable, windowR.get());   // autocorrelation
-			for (integer i = 2; i <= nsamp_window; i ++)
-				windowR [i] /= windowR [1];   // normalize
-			windowR [1] = 1.0;   // normalize
+		if (dt <= 0.0)
+			dt = periodsPerWindow / pitchFloor / 4.0;
 
-			brent_ixmax = Melder_ifloor (nsamp_window * interpolation_depth);
-		}
+		double effectivePeriodsPerWindow = periodsPerWindow;
+		integer brent_depth;
+		double interpolation_depth;
+		getMethodParameters (method, & effectivePeriodsPerWindow, & brent_depth, & interpolation_depth);
+		autoPitch thee = Pitch_createForAnalysis (me, method, effectivePeriodsPerWindow, dt, pitchFloor, & pitchCeiling, maxnCandidates);
 
-		autoMelderProgress progress (U"Sound to Pitch...");
+		autoMelderProgress progress (U"LongSound to Pitch...");
 
-		integer numberOfFramesPerThread = 20;
-		integer numberOfThreads = (numberOfFrames - 1) / numberOfFramesPerThread + 1;
-		const integer numberOfProcessors = MelderThread_getNumberOfProcessors ();
-		trace (numberOfProcessors, U" processors");
-		Melder_clipRight (& numberOfThreads, numberOfProcessors);
-		Melder_clip (1_integer, & numberOfThreads, 16_integer);
-		numberOfFramesPerThread = (numberOfFrames - 1) / numberOfThreads + 1;
-
-		autoSound_into_Pitch_Args args [16];
-		integer firstFrame = 1, lastFrame = numberOfFramesPerThread;
-		volatile int cancelled = 0;
-		for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			if (ithread == numberOfThreads)
-				lastFrame = numberOfFrames;
-			autoSound_into_Pitch_Args arg = Thing_new (Sound_into_Pitch_Args);
-			arg -> sound = me;
-			arg -> pitch = thee.get();
-			arg -> firstFrame = firstFrame;
-			arg -> lastFrame = lastFrame;
-			arg -> pitchFloor = pitchFloor;
-			arg -> maxnCandidates = maxnCandidates;
-			arg -> method = method;
-			arg -> voicingThreshold = voicingThreshold;
-			arg -> octaveCost = octaveCost;
-			arg -> dt_window = dt_window;
-			arg -> nsamp_window = nsamp_window;
-			arg -> halfnsamp_window = halfnsamp_window;
-			arg -> maximumLag = maximumLag;
-			arg -> nsampFFT = nsampFFT;
-			arg -> nsamp_period = nsamp_period;
-			arg -> halfnsamp_period = halfnsamp_period;
-			arg -> brent_ixmax = brent_ixmax;
-			arg -> brent_depth = brent_depth;
-			arg -> globalPeak = globalPeak;
-			arg -> window = window.get();
-			arg -> windowR = windowR.get();
-			arg -> isMainThread = ( ithread == numberOfThreads );
-			arg -> cancelled = & cancelled;
-			if (method >= FCC_NORMAL) {   // cross-correlation
-				arg -> frame = zero_MAT (my ny, nsamp_window);
-			} else {   // autocorrelation
-				NUMfft_Table_init (& arg -> fftTable, nsampFFT);
-				arg -> frame = zero_MAT (my ny, nsampFFT);
-				arg -> ac = zero_VEC (nsampFFT);
+		/*
+			The global absolute peak, from the extremes and the mean of each channel, in a single pass through the file.
+		*/
+		autoVEC minimum = raw_VEC (my numberOfChannels), maximum = raw_VEC (my numberOfChannels);
+		autoVEC sum = zero_VEC (my numberOfChannels);
+		minimum.all()  <<=  INFINITY;
+		maximum.all()  <<=  - INFINITY;
+		constexpr integer numberOfSamplesPerBlock = 1000000;
+		for (integer firstSample = 1; firstSample <= my nx; firstSample += numberOfSamplesPerBlock) {
+			autoSound block = LongSound_extractSamples (me, firstSample, firstSample + numberOfSamplesPerBlock - 1);
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+				const MelderRealRange extrema = NUMextrema_u (block -> z.row (ichan));
+				minimum [ichan] = std::min (minimum [ichan], extrema.min);
+				maximum [ichan] = std::max (maximum [ichan], extrema.max);
+				sum [ichan] += NUMsum (block -> z.row (ichan));
 			}
-			arg -> rbuffer = zero_VEC (2 * nsamp_window + 1);
-			arg -> r = & arg -> rbuffer [1 + nsamp_window];
-			arg -> imax = zero_INTVEC (maxnCandidates);
-			arg -> localMean = zero_VEC (my ny);
-			args [ithread - 1] = std::move (arg);
-			firstFrame = lastFrame + 1;
-			lastFrame += numberOfFramesPerThread;
+			Melder_progress (0.1 * double (firstSample) / my nx, U"LongSound to Pitch: computing the global peak");
+		}
+		double globalPeak = 0.0;
+		for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+			const double mean = sum [ichan] / my nx;
+			globalPeak = std::max (globalPeak, std::max (maximum [ichan] - mean, mean - minimum [ichan]));
 		}
-		MelderThread_run (Sound_into_Pitch, args, numberOfThreads);
+		if (globalPeak == 0.0)
+			return thee;
 
-		Melder_progress (0.95, U"Sound to Pitch: path finder");
+		/*
+			Everything that the analysis of a frame looks at: the window (plus one longest period for the cross-correlation),
+			and one longest period around the window for the local mean.
+		*/
+		const double margin = (effectivePeriodsPerWindow + 2.0) / pitchFloor + 10.0 * my dx;
+		LongSound_analyseInBlocks (me, thee.get(), margin,
+			[&] (Sound block, integer fromFrame, integer toFrame) {
+				Sound_into_Pitch_frames (block, me, thee.get(), fromFrame, toFrame, method, periodsPerWindow, pitchFloor, maxnCandidates,
+						voicingThreshold, octaveCost, globalPeak, crossCorrelationViaFFT);
+			}
+		);
+
+		Melder_progress (0.95, U"LongSound to Pitch: path finder");
 		Pitch_pathFinder (thee.get(), silenceThreshold, voicingThreshold,
 				octaveCost, octaveJumpCost, voicedUnvoicedCost, pitchCeiling, Melder_debug == 31 ? true : false);
 
@@ -548,6 +722,24 @@ autoPitch Sound_to_Pitch_any (Sound me,
 	}
 }
 
+static bool prefs_crossCorrelationViaFFT;
+
+void Sound_to_Pitch_preferences () {
+	Preferences_addBool (U"Pitch.crossCorrelationViaFFT", & prefs_crossCorrelationViaFFT, false);
+}
+
+bool Sound_to_Pitch_getCrossCorrelationViaFFTPref () {
+	return prefs_crossCorrelationViaFFT;
+}
+
+void Sound_to_Pitch_setCrossCorrelationViaFFTPref (bool crossCorrelationViaFFT) {
+	prefs_crossCorrelationViaFFT = crossCorrelationViaFFT;
+}
+
+static bool crossCorrelationViaFFT () {
+	return prefs_crossCorrelationViaFFT;
+}
+
 autoPitch Sound_to_Pitch (Sound me, double timeStep, double pitchFloor, double pitchCeiling) {
 	return Sound_to_Pitch_rawAc (me, timeStep, pitchFloor, pitchCeiling,
 			15, false, 0.03, 0.45, 0.01, 0.35, 0.14);
@@ -573,12 +765,40 @@ autoPitch Sound_to_Pitch_rawCc (Sound me,
 	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost)
 {
 	return Sound_to_Pitch_any (me, 2 + (int) veryAccurate, 1.0,
+		timeStep, pitchFloor, pitchCeiling,
+		maxnCandidates,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost,
+		crossCorrelationViaFFT ()
+	);
+}
+
+autoPitch LongSound_to_Pitch_rawAc (LongSound me,
+	double timeStep, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates, bool veryAccurate,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost)
+{
+	return LongSound_to_Pitch_any (me, (int) veryAccurate, 3.0,
 		timeStep, pitchFloor, pitchCeiling,
 		maxnCandidates,
 		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost
 	);
 }
 
+autoPitch LongSound_to_Pitch_rawCc (LongSound me,
+	double timeStep, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates, bool veryAccurate,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost)
+{
+	return LongSound_to_Pitch_any (me, 2 + (int) veryAccurate, 1.0,
+		timeStep, pitchFloor, pitchCeiling,
+		maxnCandidates,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost,
+		crossCorrelationViaFFT ()
+	);
+}
+
 autoPitch Sound_to_Pitch_filteredAc (Sound me,
 	double timeStep, double pitchFloor, double pitchTop,
 	integer maxnCandidates, bool veryAccurate,
@@ -660,7 +880,8 @@ autoPitch Sound_to_Pitch_filteredCc (Sound me,
 		return Sound_to_Pitch_any (thee.get(), 2 + (int) veryAccurate, 1.0,
 			timeStep, pitchFloor, pitchTop,
 			maxnCandidates,
-			silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost
+			silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost,
+			crossCorrelationViaFFT ()
 		);
 	} catch (MelderError) {
 		Melder_throw (me, U": pitch analysis (filtered CC) not performed.");
@@ -16,7 +16,7 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "Sound.h"
+#include "LongSound.h"
 #include "Pitch.h"
 
 autoPitch Sound_to_Pitch (Sound me, double timeStep,
@@ -35,7 +35,7 @@ autoPitch Sound_to_Pitch_rawCc (Sound me,
 	integer maxnCandidates, bool veryAccurate,
 	double silenceThreshold, double voicingThreshold, double octaveCost,
 	double octaveJumpCost, double voicedUnvoicedCost);
-/* Calls Sound_to_Pitch_any with FCC method. */
+/* Calls Sound_to_Pitch_any with FCC method; the cross-correlation is computed via the FFT only if the preference says so. */
 
 autoPitch Sound_to_Pitch_any (Sound me,
 	int method,                 // 0 or 1 = AC, 2 or 3 = FCC, 0 or 2 = fast, 1 or 3 = accurate
@@ -50,7 +50,8 @@ autoPitch Sound_to_Pitch_any (Sound me,
 	double voicingThreshold,    /* relative to purely periodic; default 0.45 */
 	double octaveCost,          /* favours higher pitches; default 0.01 */
 	double octaveJumpCost,      /* default 0.35 */
-	double voicedUnvoicedCost); /* default 0.14 */
+	double voicedUnvoicedCost,  /* default 0.14 */
+	bool crossCorrelationViaFFT = false);   // only for FCC; see below
 /*
 	Function:
 		acoustic periodicity analysis.
@@ -74,6 +75,20 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		which is the autocorrelation for lag 0. The autocorrelation is divided by
 		the normalized autocorrelation of the window, in order to bring
 		all maxima of the autocorrelation of a periodic signal to the same height.
+	Description for method 2 or 3:
+		The forward cross-correlation between the analysis window and the signal
+		from each lag onward is computed without windowing, and normalized by
+		the square root of the product of the energies of the two stretches.
+		By default the cross-correlation is computed directly, in O(window * maximumLag) time.
+		If 'crossCorrelationViaFFT' is true, the products are computed instead as a single
+		FFT-based correlation of the window with the whole stretch of signal that the lags cover
+		(O(N log N) per frame); the normalization is unchanged.
+		The "raw cc" and "filtered cc" analyses do this only if the user has switched on
+		"Compute cross-correlations via FFT" in the Pitch analysis settings
+		(see Sound_to_Pitch_setCrossCorrelationViaFFTPref below).
+		The resulting correlations differ from the direct ones by rounding only:
+		they agree within an absolute difference of 1e-9, which does not change any pitch candidate
+		beyond the precision of the sinc interpolation.
 	General description:
 		The maxima are found by sinc interpolation.
 		The pitch values (frequencies) of the highest 'maxnCandidates' maxima
@@ -86,6 +101,35 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		pitches above a certain value "voiceless".
 */
 
+autoPitch LongSound_to_Pitch_any (LongSound me,
+	int method, double periodsPerWindow,
+	double timeStep, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
+	bool crossCorrelationViaFFT = false);
+/*
+	The same as Sound_to_Pitch_any, but reads the sound in blocks,
+	so that the memory use for the sound does not depend on the duration of the LongSound;
+	the global peak is computed in a first pass through the file,
+	and the path finder runs once, after all the candidates have been found.
+	The result equals that of Sound_to_Pitch_any on the whole sound up to rounding,
+	because the global mean and peak are summed here block by block rather than over the whole signal at once;
+	this affects only the frame intensities, and thereby the strengths of the unvoiced candidates.
+*/
+
+autoPitch LongSound_to_Pitch_rawAc (LongSound me,
+	double timeStep, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates, bool veryAccurate,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost);
+
+autoPitch LongSound_to_Pitch_rawCc (LongSound me,
+	double timeStep, double pitchFloor, double pitchCeiling,
+	integer maxnCandidates, bool veryAccurate,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost);
+
 autoPitch Sound_to_Pitch_filteredAc (Sound me,
 	double timeStep, double pitchFloor, double pitchTop,
 	integer maxnCandidates, bool veryAccurate,
@@ -100,4 +144,12 @@ autoPitch Sound_to_Pitch_filteredCc (Sound me,
 	double silenceThreshold, double voicingThreshold,
 	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost);
 
+void Sound_to_Pitch_preferences ();
+bool Sound_to_Pitch_getCrossCorrelationViaFFTPref ();
+void Sound_to_Pitch_setCrossCorrelationViaFFTPref (bool crossCorrelationViaFFT);
+/*
+	Whether the "raw cc" and "filtered cc" analyses (of Sound and LongSound) compute their
+	cross-correlations via the FFT; the default is false, i.e. the direct computation.
+*/
+
 /* End of file Sound_to_Pitch.h */
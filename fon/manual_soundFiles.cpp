@@ -277,6 +277,8 @@ LIST_ITEM (U"• @@Save as AIFC file...@ (16-bit big-endian)")
 LIST_ITEM (U"• @@Save as NeXT/Sun file...@ (16-bit big-endian)")
 LIST_ITEM (U"• @@Save as NIST file...@ (16-bit little-endian)")
 LIST_ITEM (U"• @@Save as FLAC file...@ (16-bit)")
+NORMAL (U"To keep all the precision of a Sound and read it back very fast, "
+	"you can save it as a @@mappable sound file@ instead.")
 MAN_END
 
 MAN_BEGIN (U"Save as WAV file...", U"ppgb", 20110129)
@@ -419,6 +421,27 @@ INTRO (U"A command in the @@Open menu@ that creates a @LongSound object.")
 NORMAL (U"The file will be opened for reading only. The file stays open until you remove the LongSound object.")
 MAN_END
 
+MAN_BEGIN (U"mappable sound file", U"ppgb", 20261018)
+INTRO (U"A way for storing a @Sound object on disk that allows Praat to read it back in no time.")
+ENTRY (U"File format")
+NORMAL (U"After a header of 4096 bytes, the file contains the samples as 64-bit floating-point numbers, "
+	"first all samples of the first channel, then all samples of the second channel, and so on. "
+	"The numbers are stored in the byte order of the computer that wrote the file, "
+	"so that a mappable sound file cannot be read on a computer with a different byte order "
+	"(such files are rare nowadays). For exchanging sounds with other computers, "
+	"you would use a binary Praat file (@@Save as binary file...@) instead.")
+ENTRY (U"Saving")
+NORMAL (U"With ##Save as mappable sound file...#.")
+ENTRY (U"Reading")
+NORMAL (U"With @@Read from file...@. The samples are not copied from the file, but \"mapped\": "
+	"the Sound appears in the list of objects immediately, however long it is, "
+	"and a part of the Sound is read from disk only when it is first used. "
+	"This is useful for large collections of long sounds that you want to query many times.")
+NORMAL (U"If you change the Sound (e.g. with @@Formula...@), the parts that change are first copied into memory, "
+	"so that the file itself never changes. "
+	"However, you should not let other programs change the file as long as the Sound exists in Praat.")
+MAN_END
+
 MAN_BEGIN (U"Sesam/LVS files", U"ppgb", 20170828)
 INTRO (U"A way for storing a @Sound object on disk.")
 ENTRY (U"File format")
@@ -132,6 +132,86 @@ DO
 	SAVE_ONE_END
 }
 
+FORM (CONVERT_EACH_TO_ONE__LongSound_to_Formant_burg, U"LongSound: To Formant (Burg method)", U"Sound: To Formant (burg)...") {
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (maximumNumberOfFormants, U"Max. number of formants", U"5.0")
+	REAL (formantCeiling, U"Formant ceiling (Hz)", U"5500.0 (= adult female)")
+	POSITIVE (windowLength, U"Window length (s)", U"0.025")
+	POSITIVE (preEmphasisFrom, U"Pre-emphasis from (Hz)", U"50.0")
+	OK
+DO
+	CONVERT_EACH_TO_ONE (LongSound)
+		autoFormant result = LongSound_to_Formant_burg (me, timeStep,
+				maximumNumberOfFormants, formantCeiling, windowLength, preEmphasisFrom);
+	CONVERT_EACH_TO_ONE_END (my name.get())
+}
+
+FORM (CONVERT_EACH_TO_ONE__LongSound_to_Intensity, U"LongSound: To Intensity", U"Sound: To Intensity...") {
+	POSITIVE (pitchFloor, U"Pitch floor (Hz)", U"100.0")
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	BOOLEAN (subtractMean, U"Subtract mean", true)
+	OK
+DO
+	CONVERT_EACH_TO_ONE (LongSound)
+		autoIntensity result = LongSound_to_Intensity (me,
+				pitchFloor, timeStep, subtractMean);
+	CONVERT_EACH_TO_ONE_END (my name.get())
+}
+
+FORM (CONVERT_EACH_TO_ONE__LongSound_to_Pitch_rawAutocorrelation, U"LongSound: To Pitch (raw autocorrelation)", U"Sound: To Pitch (raw autocorrelation)...") {
+	HEADING (U"Where to search...")
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (pitchFloor, U"left Pitch floor and ceiling (Hz)", U"75.0")
+	POSITIVE (pitchCeiling, U"right Pitch floor and ceiling (Hz)", U"600.0")
+	HEADING (U"How to find the candidates...")
+	NATURAL (maximumNumberOfCandidates, U"Max. number of candidates", U"15")
+	BOOLEAN (veryAccurate, U"Very accurate", false)
+	HEADING (U"How to find a path through the candidates...")
+	REAL (silenceThreshold, U"Silence threshold", U"0.03")
+	REAL (voicingThreshold, U"Voicing threshold", U"0.45")
+	REAL (octaveCost, U"Octave cost", U"0.01")
+	REAL (octaveJumpCost, U"Octave-jump cost", U"0.35")
+	REAL (voicedUnvoicedCost, U"Voiced / unvoiced cost", U"0.14")
+	OK
+DO
+	Melder_require (maximumNumberOfCandidates > 1,
+		U"Your maximum number of candidates should be greater than 1.");
+	CONVERT_EACH_TO_ONE (LongSound)
+		autoPitch result = LongSound_to_Pitch_rawAc (me,
+			timeStep, pitchFloor, pitchCeiling,
+			maximumNumberOfCandidates, veryAccurate,
+			silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost
+		);
+	CONVERT_EACH_TO_ONE_END (my name.get())
+}
+
+FORM (CONVERT_EACH_TO_ONE__LongSound_to_Pitch_rawCrossCorrelation, U"LongSound: To Pitch (raw cross-correlation)", U"Sound: To Pitch (raw cross-correlation)...") {
+	HEADING (U"Where to search...")
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (pitchFloor, U"left Pitch floor and ceiling (Hz)", U"75.0")
+	POSITIVE (pitchCeiling, U"right Pitch floor and ceiling (Hz)", U"600.0")
+	HEADING (U"How to find the candidates...")
+	NATURAL (maximumNumberOfCandidates, U"Max. number of candidates", U"15")
+	BOOLEAN (veryAccurate, U"Very accurate", false)
+	HEADING (U"How to find a path through the candidates...")
+	REAL (silenceThreshold, U"Silence threshold", U"0.03")
+	REAL (voicingThreshold, U"Voicing threshold", U"0.45")
+	REAL (octaveCost, U"Octave cost", U"0.01")
+	REAL (octaveJumpCost, U"Octave-jump cost", U"0.35")
+	REAL (voicedUnvoicedCost, U"Voiced / unvoiced cost", U"0.14")
+	OK
+DO
+	Melder_require (maximumNumberOfCandidates > 1,
+		U"Your maximum number of candidates should be greater than 1.");
+	CONVERT_EACH_TO_ONE (LongSound)
+		autoPitch result = LongSound_to_Pitch_rawCc (me,
+			timeStep, pitchFloor, pitchCeiling,
+			maximumNumberOfCandidates, veryAccurate,
+			silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost
+		);
+	CONVERT_EACH_TO_ONE_END (my name.get())
+}
+
 FORM (NEW_LongSound_to_TextGrid, U"LongSound: To TextGrid...", U"LongSound: To TextGrid...") {
 	SENTENCE (tierNames, U"Tier names", U"Mary John bell")
 	SENTENCE (pointTiers, U"Point tiers", U"bell")
@@ -271,6 +351,19 @@ DO
 	PREFS_END
 }
 
+FORM (SETTINGS__PitchAnalysisSettings, U"Pitch analysis settings", nullptr) {
+	COMMENT (U"This setting applies to \"To Pitch (raw cc)...\" and \"To Pitch (filtered cc)...\".")
+	BOOLEAN (computeCrossCorrelationsViaFFT, U"Compute cross-correlations via FFT", false)
+	COMMENT (U"The FFT is faster for low pitch floors, but the results can differ")
+	COMMENT (U"from those of the standard (direct) computation by rounding.")
+OK
+	SET_BOOLEAN (computeCrossCorrelationsViaFFT, Sound_to_Pitch_getCrossCorrelationViaFFTPref ())
+DO
+	PREFS
+		Sound_to_Pitch_setCrossCorrelationViaFFTPref (computeCrossCorrelationsViaFFT);
+	PREFS_END
+}
+
 /********** LONGSOUND & SOUND **********/
 
 FORM_SAVE (SAVE_ALL__LongSound_Sound_saveAsAifcFile, U"Save as AIFC file", nullptr, U"aifc") {
@@ -2014,6 +2107,12 @@ FORM_SAVE (SAVE_ONE__Sound_saveAsSesamFile, U"Save as Sesam file", nullptr, U"sd
 	SAVE_ONE_END
 }
 
+FORM_SAVE (SAVE_ONE__Sound_saveAsMappableFile, U"Save as mappable sound file", nullptr, U"msound") {
+	SAVE_ONE (Sound)
+		Sound_saveAsMappableFile (me, file);
+	SAVE_ONE_END
+}
+
 FORM_SAVE (SAVE_ALL__Sound_saveAsStereoAifcFile, U"Save as stereo AIFC file", nullptr, U"aifc") {
 	SAVE_ALL (Sound)
 		autoSound stereo = Sounds_combineToStereo (& list);
@@ -2159,6 +2258,12 @@ static autoDaata sesamFileRecognizer (integer nread, const char * /* header */,
 	return Sound_readFromSesamFile (file);
 }
 
+static autoDaata mappableSoundFileRecognizer (integer nread, const char *header, MelderFile file) {
+	if (! Sound_isMappableFileHeader (nread, header))
+		return autoDaata ();
+	return Sound_readFromMappableFile (file);
+}
+
 static autoDaata bellLabsFileRecognizer (integer nread, const char *header, MelderFile file) {
 	if (nread < 16 || ! strnequ (& header [0], "SIG\n", 4))
 		return autoDaata ();
@@ -2225,6 +2330,7 @@ void praat_Sound_init () {
 	Data_recognizeFileType (soundFileRecognizer);
 	Data_recognizeFileType (movieFileRecognizer);
 	Data_recognizeFileType (sesamFileRecognizer);
+	Data_recognizeFileType (mappableSoundFileRecognizer);
 	Data_recognizeFileType (bellLabsFileRecognizer);
 	Data_recognizeFileType (kayFileRecognizer);
 
@@ -2235,6 +2341,7 @@ void praat_Sound_init () {
 	structSoundRecorder           :: f_preferences ();
 	structFunctionEditor          :: f_preferences ();
 	LongSound_preferences ();
+	Sound_to_Pitch_preferences ();
 
 	Melder_setRecordProc (recordProc);
 	Melder_setRecordFromFileProc (recordFromFileProc);
@@ -2276,6 +2383,8 @@ void praat_Sound_init () {
 			SETTINGS__SoundPlayingSettings);   // alternative GuiMenu_DEPRECATED_2023
 	praat_addMenuCommand (U"Objects", U"Settings", U"LongSound settings... || LongSound preferences...", nullptr, 0,
 			SETTINGS__LongSoundSettings);   // alternative GuiMenu_DEPRECATED_2023
+	praat_addMenuCommand (U"Objects", U"Settings", U"Pitch analysis settings...", nullptr, 0,
+			SETTINGS__PitchAnalysisSettings);
 #ifdef HAVE_PULSEAUDIO
 	praat_addMenuCommand (U"Objects", U"Technical", U"Report sound server properties", U"Report system properties", 0,
 			INFO_NONE__Praat_reportSoundServerProperties);
@@ -2304,6 +2413,15 @@ void praat_Sound_init () {
 				HELP__AnnotationTutorial);
 		praat_addAction1 (classLongSound, 0, U"-- to text grid --", nullptr, 1, nullptr);
 		praat_addAction1 (classLongSound, 0, U"To TextGrid...", nullptr, 1, NEW_LongSound_to_TextGrid);
+	praat_addAction1 (classLongSound, 0, U"Analyse -", nullptr, 0, nullptr);
+		praat_addAction1 (classLongSound, 0, U"To Pitch (raw autocorrelation)... || To Pitch (raw ac)...", nullptr, 1,
+				CONVERT_EACH_TO_ONE__LongSound_to_Pitch_rawAutocorrelation);
+		praat_addAction1 (classLongSound, 0, U"To Pitch (raw cross-correlation)... || To Pitch (raw cc)...", nullptr, 1,
+				CONVERT_EACH_TO_ONE__LongSound_to_Pitch_rawCrossCorrelation);
+		praat_addAction1 (classLongSound, 0, U"To Intensity...", nullptr, 1,
+				CONVERT_EACH_TO_ONE__LongSound_to_Intensity);
+		praat_addAction1 (classLongSound, 0, U"To Formant (burg)...", nullptr, 1,
+				CONVERT_EACH_TO_ONE__LongSound_to_Formant_burg);
 	praat_addAction1 (classLongSound, 0, U"Convert to Sound", nullptr, 0, nullptr);
 	praat_addAction1 (classLongSound, 0, U"Extract part...", nullptr, 0, NEW_LongSound_extractPart);
 	praat_addAction1 (classLongSound, 0, U"Concatenate?", nullptr, 0,
@@ -2365,6 +2483,8 @@ void praat_Sound_init () {
 			nullptr, 0, SAVE_ONE__Sound_saveAsKayFile);
 	praat_addAction1 (classSound, 1, U"Save as Sesam file... || Write to Sesam file...",
 			nullptr, GuiMenu_HIDDEN, SAVE_ONE__Sound_saveAsSesamFile);
+	praat_addAction1 (classSound, 1, U"Save as mappable sound file...",
+			nullptr, 0, SAVE_ONE__Sound_saveAsMappableFile);
 	praat_addAction1 (classSound, 0, U"Save as 24-bit WAV file...", nullptr, 0,
 			SAVE_ALL__Sound_saveAs24BitWavFile);
 	praat_addAction1 (classSound, 0, U"Save as 32-bit WAV file...", nullptr, 0,
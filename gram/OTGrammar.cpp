@@ -73,6 +73,8 @@
  */
 
 #include "OTGrammar.h"
+#include "MelderThread.h"
+#include <atomic>
 
 #include "oo_DESTROY.h"
 #include "OTGrammar_def.h"
@@ -331,15 +333,23 @@ void OTGrammar_sort (OTGrammar me) {
 	}
 }
 
-void OTGrammar_newDisharmonies (OTGrammar me, double spreading) {
+/*
+	The `_mt` versions draw their random numbers from generator number `threadNumber` (0 to 16);
+	generator 0 is the one used by NUMrandomGauss () and NUMrandomUniform ().
+*/
+static void OTGrammar_newDisharmonies_mt (OTGrammar me, double spreading, int threadNumber) {
 	for (integer icons = 1; icons <= my numberOfConstraints; icons ++) {
 		OTGrammarConstraint constraint = & my constraints [icons];
-		constraint -> disharmony = constraint -> ranking + NUMrandomGauss (0, spreading)
+		constraint -> disharmony = constraint -> ranking + NUMrandomGauss_mt (threadNumber, 0, spreading)
 			/*NUMrandomUniform (-spreading, spreading)*/;
 	}
 	OTGrammar_sort (me);
 }
 
+void OTGrammar_newDisharmonies (OTGrammar me, double spreading) {
+	OTGrammar_newDisharmonies_mt (me, spreading, 0);
+}
+
 integer OTGrammar_getTableau (OTGrammar me, conststring32 input) {
 	for (integer itab = 1; itab <= my numberOfTableaus; itab ++)
 		if (str32equ (my tableaus [itab]. input.get(), input))
@@ -483,14 +493,14 @@ static void _OTGrammar_fillInProbabilities (OTGrammar me, integer itab) {
 	}
 }
 
-integer OTGrammar_getWinner (OTGrammar me, integer itab) {
+static integer OTGrammar_getWinner_mt (OTGrammar me, integer itab, int threadNumber) {
 	integer icand_best = 1;
 	if (my decisionStrategy == kOTGrammar_decisionStrategy::MAXIMUM_ENTROPY ||
 		my decisionStrategy == kOTGrammar_decisionStrategy::EXPONENTIAL_MAXIMUM_ENTROPY)
 	{
 		_OTGrammar_fillInHarmonies (me, itab);
 		_OTGrammar_fillInProbabilities (me, itab);
-		double cutOff = NUMrandomUniform (0.0, 1.0);
+		double cutOff = NUMrandomFraction_mt (threadNumber);
 		longdouble sumOfProbabilities = 0.0;
 		for (integer icand = 1; icand <= my tableaus [itab]. numberOfCandidates; icand ++) {
 			sumOfProbabilities += my tableaus [itab]. candidates [icand]. probability;
@@ -515,7 +525,7 @@ integer OTGrammar_getWinner (OTGrammar me, integer itab) {
 					icand_best = icand_best;   // keep first
 				} else if (Melder_debug == 42) {
 					icand_best = icand;   // take last
-				} else if (NUMrandomUniform (0.0, numberOfBestCandidates) < 1.0) {   // default: take random
+				} else if (numberOfBestCandidates * NUMrandomFraction_mt (threadNumber) < 1.0) {   // default: take random
 					icand_best = icand;
 				}
 			}
@@ -524,6 +534,10 @@ integer OTGrammar_getWinner (OTGrammar me, integer itab) {
 	return icand_best;
 }
 
+integer OTGrammar_getWinner (OTGrammar me, integer itab) {
+	return OTGrammar_getWinner_mt (me, itab, 0);
+}
+
 integer OTGrammar_getNumberOfOptimalCandidates (OTGrammar me, integer itab) {
 	if (my decisionStrategy == kOTGrammar_decisionStrategy::MAXIMUM_ENTROPY ||
 		my decisionStrategy == kOTGrammar_decisionStrategy::EXPONENTIAL_MAXIMUM_ENTROPY) return 1;
@@ -1059,6 +1073,64 @@ autoStrings OTGrammar_inputToOutputs (OTGrammar me, conststring32 input, integer
 	}
 }
 
+/*
+	The trials for every input are divided over a fixed number of streams of random numbers,
+	each of which evaluates its share of the trials for all the tableaus in turn, with its own copy of the grammar.
+	The streams are distributed over the threads, but stream number `istream` always draws from random generator `istream`,
+	so that the counts do not depend on the number of threads, and are reproducible
+	after random_initializeWithSeedUnsafelyButPredictably ().
+	Generator 0 is left alone: it belongs to the main thread.
+*/
+constexpr integer OTGrammar_NUMBER_OF_RANDOM_STREAMS = 16;
+
+/*
+	Adds the winners of `trialsPerInput` evaluations of every tableau to `counts`,
+	which has a row for every candidate, numbered consecutively through all the tableaus.
+*/
+static void OTGrammar_countWinners (OTGrammar me, integer trialsPerInput, double noise, VECVU const& counts) {
+	const integer numberOfStreams = OTGrammar_NUMBER_OF_RANDOM_STREAMS;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfStreams, 1);
+	OrderedOf <structOTGrammar> grammars;   // one for every thread, because evaluation changes the disharmonies and the order of the constraints
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		grammars. addItem_move (Data_copy (me));
+	autoMAT streamCounts = zero_MAT (numberOfStreams, counts.size);
+	std::atomic <integer> numberOfTableausDone (0);
+	std::atomic <bool> cancelled (false);
+	MelderThread_runChunked (numberOfThreads, numberOfStreams, 1,
+		[&] (integer ithread, integer fromStream, integer toStream) {
+			const OTGrammar grammar = grammars.at [ithread];
+			for (integer istream = fromStream; istream <= toStream; istream ++) {
+				const integer firstTrial = (istream - 1) * trialsPerInput / numberOfStreams + 1;
+				const integer lastTrial = istream * trialsPerInput / numberOfStreams;
+				integer offset = 0;
+				for (integer itab = 1; itab <= grammar -> numberOfTableaus; itab ++) {
+					const OTGrammarTableau tableau = & grammar -> tableaus [itab];
+					if (ithread == 1) {   // the calling thread, see MelderThread_runChunked
+						try {
+							Melder_progress ((numberOfTableausDone + 0.5) / (numberOfStreams * grammar -> numberOfTableaus),
+									U"Measuring input \"", tableau -> input.get(), U"\"");
+						} catch (MelderError) {
+							cancelled = true;
+							throw;
+						}
+					} else if (cancelled) {
+						return;
+					}
+					for (integer itrial = firstTrial; itrial <= lastTrial; itrial ++) {
+						OTGrammar_newDisharmonies_mt (grammar, noise, int (istream));
+						const integer iwinner = OTGrammar_getWinner_mt (grammar, itab, int (istream));
+						streamCounts [istream] [offset + iwinner] += 1.0;
+					}
+					offset += tableau -> numberOfCandidates;
+					++ numberOfTableausDone;
+				}
+			}
+		}
+	);
+	for (integer istream = 1; istream <= numberOfStreams; istream ++)
+		counts  +=  streamCounts.row (istream);
+}
+
 autoDistributions OTGrammar_to_Distribution (OTGrammar me, integer trialsPerInput, double noise) {
 	try {
 		integer totalNumberOfOutputs = 0, nout = 0;
@@ -1072,33 +1144,22 @@ autoDistributions OTGrammar_to_Distribution (OTGrammar me, integer trialsPerInpu
 		*/
 		autoDistributions thee = Distributions_create (totalNumberOfOutputs, 1);
 		/*
-			Measure every input form.
+			Set the row labels to the output strings.
 		*/
-		autoMelderProgress progress (U"OTGrammar: compute output distribution.");
 		for (integer itab = 1; itab <= my numberOfTableaus; itab ++) {
 			OTGrammarTableau tableau = & my tableaus [itab];
-			Melder_progress ((itab - 0.5) / my numberOfTableaus, U"Measuring input \"", tableau -> input.get(), U"\"");
-			/*
-				Set the row labels to the output strings.
-			*/
 			for (integer icand = 1; icand <= tableau -> numberOfCandidates; icand ++) {
 				thy rowLabels [nout + icand] = Melder_dup (
 					Melder_cat (tableau -> input.get(), U" \\-> ", tableau -> candidates [icand]. output.get())
 				);
 			}
-			/*
-				Compute a number of outputs and store the results.
-			*/
-			for (integer itrial = 1; itrial <= trialsPerInput; itrial ++) {
-				OTGrammar_newDisharmonies (me, noise);
-				integer iwinner = OTGrammar_getWinner (me, itab);
-				thy data [nout + iwinner] [1] += 1;
-			}
-			/*
-				Update the offset.
-			*/
 			nout += tableau -> numberOfCandidates;
 		}
+		/*
+			Measure every input form.
+		*/
+		autoMelderProgress progress (U"OTGrammar: compute output distribution.");
+		OTGrammar_countWinners (me, trialsPerInput, noise, thy data.column (1));
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": output distribution not computed.");
@@ -1107,37 +1168,26 @@ autoDistributions OTGrammar_to_Distribution (OTGrammar me, integer trialsPerInpu
 
 autoPairDistribution OTGrammar_to_PairDistribution (OTGrammar me, integer trialsPerInput, double noise) {
 	try {
-		integer nout = 0;
 		/*
 			Create the distribution. One row for every output form.
 		*/
 		autoPairDistribution thee = PairDistribution_create ();
 		/*
-			Measure every input form.
+			Copy the input and output strings to the target object.
 		*/
-		autoMelderProgress progress (U"OTGrammar: compute output distribution.");
 		for (integer itab = 1; itab <= my numberOfTableaus; itab ++) {
 			OTGrammarTableau tableau = & my tableaus [itab];
-			Melder_progress ((itab - 0.5) / my numberOfTableaus, U"Measuring input \"", tableau -> input.get(), U"\"");
-			/*
-				Copy the input and output strings to the target object.
-			*/
-			for (integer icand = 1; icand <= tableau -> numberOfCandidates; icand ++) {
+			for (integer icand = 1; icand <= tableau -> numberOfCandidates; icand ++)
 				PairDistribution_add (thee.get(), tableau -> input.get(), tableau -> candidates [icand]. output.get(), 0.0);
-			}
-			/*
-				Compute a number of outputs and store the results.
-			*/
-			for (integer itrial = 1; itrial <= trialsPerInput; itrial ++) {
-				OTGrammar_newDisharmonies (me, noise);
-				integer iwinner = OTGrammar_getWinner (me, itab);
-				thy pairs.at [nout + iwinner] -> weight += 1.0;
-			}
-			/*
-				Update the offset.
-			*/
-			nout += tableau -> numberOfCandidates;
 		}
+		/*
+			Measure every input form.
+		*/
+		autoMelderProgress progress (U"OTGrammar: compute output distribution.");
+		autoVEC counts = zero_VEC (thy pairs.size);
+		OTGrammar_countWinners (me, trialsPerInput, noise, counts.get());
+		for (integer ipair = 1; ipair <= thy pairs.size; ipair ++)
+			thy pairs.at [ipair] -> weight += counts [ipair];
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": output distribution not computed.");
@@ -1294,9 +1294,20 @@ INTRO (U"Causes every selected @OTGrammar object to process one input/output pai
 	"and @@OT learning 5. Learning a stochastic grammar@.")
 MAN_END
 
-MAN_BEGIN (U"OTGrammar: To output Distributions...", U"ppgb", 19981230)
+MAN_BEGIN (U"OTGrammar: To output Distributions...", U"ppgb", 20261018)
 INTRO (U"A command to ask the selected @OTGrammar object to evaluate a number of times the candidates associated "
 	"with every input form. The result is a @Distributions object. See @@OT learning 2.9. Output distributions@.")
+ENTRY (U"Settings")
+TERM (U"##Trials per input# (standard value: 100000)")
+DEFINITION (U"the number of evaluations that you want to perform for every input form.")
+TERM (U"##Evaluation noise# (standard value: 2.0)")
+DEFINITION (U"the standard deviation of the noise added to the ranking value of every constraint during the evaluations. "
+	"See @@OT learning 2.4. Evaluation@.")
+ENTRY (U"Reproducibility")
+NORMAL (U"The evaluations are divided over 16 independent streams of random numbers, "
+	"which are computed in parallel if your computer has multiple processors. "
+	"The outcome does not depend on the number of processors, so if you want to get the same outcome every time, "
+	"you can call @`random_initializeWithSeedUnsafelyButPredictably` before this command in your script.")
 MAN_END
 
 MAN_BEGIN (U"OTGrammar & PairDistribution: Find positive weights...", U"ppgb", 20080331)
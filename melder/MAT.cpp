@@ -18,6 +18,7 @@
 
 #include "melder.h"
 #include "../dwsys/NUM2.h"
+#include "../sys/MelderThread.h"
 //#include "../external/gsl/gsl_blas.h"
 
 #ifdef macintosh
@@ -358,7 +359,137 @@ static inline void MATmul_rough_naiveReferenceImplementation (MATVU const& targe
 		}
 	}
 }
+/*
+	Blocked matrix multiplication for large matrices.
+
+	The target is computed in panels of KC terms at a time (so that a sliver of y stays in L1),
+	for blocks of MC rows of x (which stay in L2) and NC columns of y (which stay in L3).
+	Before use, each panel of x and y is copied ("packed") into a contiguous buffer,
+	in the order in which the micro-kernel will read it:
+	slivers of MR rows of x, and slivers of NR columns of y, each zero-padded at the edges.
+	The micro-kernel then computes an MR x NR block of the target
+	in MR * NR local accumulators, which the compiler keeps in (SIMD) registers.
+
+	The blocks of MC rows are distributed over the threads.
+	Every cell of the target is the sum of the same terms in the same order,
+	whichever thread computes it, so the result does not depend on the number of threads.
+
+	Because the matrices are packed, the strides of x and y do not matter;
+	this is why X'.Y and X.Y' are as fast as X.Y.
+
+	On a single thread of a Xeon server, with SSE2 only,
+	the speed for X.Y is 7.33, 8.18, 8.37, 7.26 Gflop/s for size = 200, 500, 1000, 2000,
+	against 1.67, 1.65, 1.86, 1.71 Gflop/s for _mul_allowAllocation_MAT_out
+	(see test/speed/matmul.praat); it is some 2.5 times faster again if the compiler may use AVX2 and FMA.
+*/
+constexpr integer MATmul_blocked_MR = 4;
+constexpr integer MATmul_blocked_NR = 8;
+constexpr integer MATmul_blocked_MC = 96;
+constexpr integer MATmul_blocked_KC = 256;
+constexpr integer MATmul_blocked_NC = 2048;
+
+static inline void MATmul_blocked_microKernel (integer const numberOfTerms,
+	const double *packedX, const double *packedY, double *target, integer const targetRowStride, integer const targetColStride,
+	integer const numberOfRows, integer const numberOfColumns) noexcept
+{
+	double sum [MATmul_blocked_MR] [MATmul_blocked_NR] = { };
+	for (integer k = 1; k <= numberOfTerms; k ++) {
+		for (integer i = 0; i < MATmul_blocked_MR; i ++)
+			for (integer j = 0; j < MATmul_blocked_NR; j ++)
+				sum [i] [j] += packedX [i] * packedY [j];
+		packedX += MATmul_blocked_MR;
+		packedY += MATmul_blocked_NR;
+	}
+	for (integer i = 0; i < numberOfRows; i ++)
+		for (integer j = 0; j < numberOfColumns; j ++)
+			target [i * targetRowStride + j * targetColStride] += sum [i] [j];
+}
+
+static void MATmul_blocked_packX (double *packed, constMATVU const& x,
+	integer const fromRow, integer const numberOfRows, integer const fromTerm, integer const numberOfTerms) noexcept
+{
+	for (integer irow = 0; irow < numberOfRows; irow += MATmul_blocked_MR) {
+		const integer numberOfRowsInSliver = std::min (MATmul_blocked_MR, numberOfRows - irow);
+		const double *xcell = & x [fromRow + irow] [fromTerm];
+		for (integer k = 0; k < numberOfTerms; k ++) {
+			for (integer i = 0; i < numberOfRowsInSliver; i ++)
+				*packed ++ = xcell [i * x.rowStride + k * x.colStride];
+			for (integer i = numberOfRowsInSliver; i < MATmul_blocked_MR; i ++)
+				*packed ++ = 0.0;
+		}
+	}
+}
+
+static void MATmul_blocked_packY (double *packed, constMATVU const& y, double const alpha,
+	integer const fromTerm, integer const numberOfTerms, integer const fromColumn, integer const numberOfColumns) noexcept
+{
+	for (integer icol = 0; icol < numberOfColumns; icol += MATmul_blocked_NR) {
+		const integer numberOfColumnsInSliver = std::min (MATmul_blocked_NR, numberOfColumns - icol);
+		const double *ycell = & y [fromTerm] [fromColumn + icol];
+		for (integer k = 0; k < numberOfTerms; k ++) {
+			for (integer j = 0; j < numberOfColumnsInSliver; j ++)
+				*packed ++ = alpha * ycell [k * y.rowStride + j * y.colStride];
+			for (integer j = numberOfColumnsInSliver; j < MATmul_blocked_NR; j ++)
+				*packed ++ = 0.0;
+		}
+	}
+}
+
+static bool MATmul_blocked_isWorthwhile (MATVU const& target, constMATVU const& x) noexcept {
+	/*
+		Below size 128 or so, packing costs more than it gains.
+	*/
+	return target.nrow >= 2 * MATmul_blocked_MR && target.ncol >= 2 * MATmul_blocked_NR && x.ncol >= 16 &&
+			double (target.nrow) * double (target.ncol) * double (x.ncol) >= 2e6;
+}
+
+void _mul_blocked_MAT_inout (MATVU const& target, double const alpha, constMATVU const& x, constMATVU const& y, double const beta) {
+	const integer numberOfRowBlocks = 1 + (target.nrow - 1) / MATmul_blocked_MC;
+	const double numberOfFlops = 2.0 * double (target.nrow) * double (target.ncol) * double (x.ncol);
+	const integer numberOfThreads = ( numberOfFlops < 1e7 ? 1 :
+			MelderThread_computeNumberOfThreads (numberOfRowBlocks, 1) );
+	autoMAT packedX = raw_MAT (numberOfThreads, MATmul_blocked_MC * MATmul_blocked_KC);   // one panel per thread
+	autoVEC packedY = raw_VEC (MATmul_blocked_KC * (MATmul_blocked_NC + MATmul_blocked_NR));   // shared
+	if (beta == 0.0)
+		target  <<=  0.0;   // even if target contains NaNs
+	else if (beta != 1.0)
+		target  *=  beta;
+	for (integer fromColumn = 1; fromColumn <= target.ncol; fromColumn += MATmul_blocked_NC) {
+		const integer numberOfColumns = std::min (MATmul_blocked_NC, target.ncol - fromColumn + 1);
+		for (integer fromTerm = 1; fromTerm <= x.ncol; fromTerm += MATmul_blocked_KC) {
+			const integer numberOfTerms = std::min (MATmul_blocked_KC, x.ncol - fromTerm + 1);
+			MATmul_blocked_packY (& packedY [1], y, alpha, fromTerm, numberOfTerms, fromColumn, numberOfColumns);
+			MelderThread_runChunked (numberOfThreads, numberOfRowBlocks, 1,
+				[&] (integer ithread, integer fromBlock, integer toBlock) {
+					double *myPackedX = & packedX [ithread] [1];
+					for (integer iblock = fromBlock; iblock <= toBlock; iblock ++) {
+						const integer fromRow = 1 + (iblock - 1) * MATmul_blocked_MC;
+						const integer numberOfRows = std::min (MATmul_blocked_MC, target.nrow - fromRow + 1);
+						MATmul_blocked_packX (myPackedX, x, fromRow, numberOfRows, fromTerm, numberOfTerms);
+						for (integer jr = 0; jr < numberOfColumns; jr += MATmul_blocked_NR)
+							for (integer ir = 0; ir < numberOfRows; ir += MATmul_blocked_MR)
+								MATmul_blocked_microKernel (numberOfTerms,
+									myPackedX + ir * numberOfTerms, & packedY [1] + jr * numberOfTerms,
+									& target [fromRow + ir] [fromColumn + jr], target.rowStride, target.colStride,
+									std::min (MATmul_blocked_MR, numberOfRows - ir),
+									std::min (MATmul_blocked_NR, numberOfColumns - jr)
+								);
+					}
+				}
+			);
+		}
+	}
+}
+
 void _mul_fast_MAT_out (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
+	if (MATmul_blocked_isWorthwhile (target, x)) {
+		try {
+			_mul_blocked_MAT_inout (target, 1.0, x, y, 0.0);
+			return;
+		} catch (MelderError) {
+			Melder_clearError ();   // out of memory for the packed panels: fall back on the unblocked loops below
+		}
+	}
 	if ((false)) {
 		MATmul_rough_naiveReferenceImplementation (target, x, y);
 	} else if (y.colStride == 1) {
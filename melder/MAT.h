@@ -389,6 +389,8 @@ inline autoMAT mul_allowAllocation_MAT (constMATVU const& x, constMATVU const& y
 }
 /*
 	Rough matrix multiplication, using an in-cache inner loop if that is faster.
+	Large matrices are multiplied in cache-sized blocks, distributed over multiple threads;
+	the result does not depend on the number of threads.
 */
 extern void _mul_fast_MAT_out (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept;
 inline void mul_fast_MAT_out  (MATVU const& target, constMATVU const& x, constMATVU const& y) {
@@ -402,6 +404,13 @@ inline autoMAT mul_fast_MAT (constMATVU const& x, constMATVU const& y) {
 	mul_fast_MAT_out (result.all(), x, y);
 	return result;
 }
+/*
+	target := alpha * x.y + beta * target, as in the BLAS routine dgemm, in cache-sized blocks on multiple threads.
+	Worthwhile only for large matrices, because x and y are copied into packed buffers (hence the allocation);
+	used by mul_fast_MAT_out and by the level-3 BLAS routines in external/clapack.
+	If beta is zero, target does not have to be initialized.
+*/
+extern void _mul_blocked_MAT_inout (MATVU const& target, double alpha, constMATVU const& x, constMATVU const& y, double beta);
 void MATmul_forceMetal_ (MATVU const& target, constMATVU const& x, constMATVU const& y);
 void MATmul_forceOpenCL_ (MATVU const& target, constMATVU const& x, constMATVU const& y);
 
@@ -170,6 +170,14 @@ double bingetr64 (FILE *f);   void binputr64 (double x, FILE *f);
 */
 double bingetr64LE (FILE *f);   void binputr64LE (double x, FILE *f);   // least significant bit first
 
+void bingetr64 (VEC const& x, FILE *f);   void binputr64 (constVEC const& x, FILE *f);
+void bingetr32 (VEC const& x, FILE *f);   // only for reading old files
+/*
+	Read or write a whole vector of real numbers, in the same formats as above,
+	and with the same results as reading or writing the numbers one by one,
+	but with a single `fread` or a few `fwrite` calls rather than one per number.
+*/
+
 double bingetr80 (FILE *f);   void binputr80 (double x, FILE *f);
 /*
 	Read or write a real number from or to 10 bytes in the stream `f`,
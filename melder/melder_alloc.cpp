@@ -18,9 +18,25 @@
 
 #include "melder.h"
 #include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#if defined (UNIX) || defined (macintosh)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
-static int64 totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0,
-	totalNumberOfMovingReallocs = 0, totalNumberOfReallocsInSitu = 0;
+/*
+	The counters are updated from worker threads as well (e.g. in Table_formula_columnRange_inParallel),
+	so they are atomic; they are statistics only, so relaxed ordering suffices.
+*/
+static std::atomic <int64> totalNumberOfAllocations (0), totalNumberOfDeallocations (0), totalAllocationSize (0),
+	totalNumberOfMovingReallocs (0), totalNumberOfReallocsInSitu (0);
+
+static inline void addToCounter (std::atomic <int64> & counter, int64 increment) {
+	counter.fetch_add (increment, std::memory_order_relaxed);
+}
 
 /*
  * The rainy-day fund.
@@ -63,8 +79,8 @@ void * _Melder_malloc (int64 size) {
 		Melder_throw (U"Out of memory: there is not enough room for another ", Melder_bigInteger (size), U" bytes.");
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_malloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t1");
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	addToCounter (totalNumberOfAllocations, 1);
+	addToCounter (totalAllocationSize, size);
 	return result;
 }
 
@@ -85,8 +101,8 @@ void * _Melder_malloc_f (int64 size) {
 		else
 			Melder_fatal (U"Out of memory: there is not enough room for another ", Melder_bigInteger (size), U" bytes.");
 	}
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	addToCounter (totalNumberOfAllocations, 1);
+	addToCounter (totalAllocationSize, size);
 	return result;
 }
 
@@ -97,7 +113,7 @@ void _Melder_free (void **ptr) noexcept {
 		Melder_casual (U"Melder_free\t", Melder_pointer (*ptr), U"\t?\t?");
 	free (*ptr);
 	*ptr = nullptr;
-	totalNumberOfDeallocations += 1;
+	addToCounter (totalNumberOfDeallocations, 1);
 }
 
 void * Melder_realloc (void *ptr, int64 size) {
@@ -111,15 +127,15 @@ void * Melder_realloc (void *ptr, int64 size) {
 	if (! ptr) {   // is it like malloc?
 		if (Melder_debug == 34)
 			Melder_casual (U"Melder_realloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t1");
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
+		addToCounter (totalNumberOfAllocations, 1);
+		addToCounter (totalAllocationSize, size);
 	} else if (result != ptr) {   // did realloc do a malloc-and-free?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
-		totalNumberOfDeallocations += 1;
-		totalNumberOfMovingReallocs += 1;
+		addToCounter (totalNumberOfAllocations, 1);
+		addToCounter (totalAllocationSize, size);
+		addToCounter (totalNumberOfDeallocations, 1);
+		addToCounter (totalNumberOfMovingReallocs, 1);
 	} else {
-		totalNumberOfReallocsInSitu += 1;
+		addToCounter (totalNumberOfReallocsInSitu, 1);
 	}
 	return result;
 }
@@ -142,15 +158,15 @@ void * Melder_realloc_f (void *ptr, int64 size) {
 			Melder_fatal (U"Out of memory. Could not extend room to ", Melder_bigInteger (size), U" bytes.");
 	}
 	if (! ptr) {   // is it like malloc?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
+		addToCounter (totalNumberOfAllocations, 1);
+		addToCounter (totalAllocationSize, size);
 	} else if (result != ptr) {   // did realloc do a malloc-and-free?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
-		totalNumberOfDeallocations += 1;
-		totalNumberOfMovingReallocs += 1;
+		addToCounter (totalNumberOfAllocations, 1);
+		addToCounter (totalAllocationSize, size);
+		addToCounter (totalNumberOfDeallocations, 1);
+		addToCounter (totalNumberOfMovingReallocs, 1);
 	} else {
-		totalNumberOfReallocsInSitu += 1;
+		addToCounter (totalNumberOfReallocsInSitu, 1);
 	}
 	return result;
 }
@@ -168,8 +184,8 @@ void * _Melder_calloc (int64 nelem, int64 elsize) {
 		Melder_throw (U"Out of memory: there is not enough room for ", Melder_bigInteger (nelem), U" more elements whose sizes are ", elsize, U" bytes each.");
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_calloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (nelem), U"\t", Melder_bigInteger (elsize));
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += nelem * elsize;
+	addToCounter (totalNumberOfAllocations, 1);
+	addToCounter (totalAllocationSize, nelem * elsize);
 	return result;
 }
 
@@ -193,8 +209,8 @@ void * _Melder_calloc_f (int64 nelem, int64 elsize) {
 			Melder_fatal (U"Out of memory: there is not enough room for ", Melder_bigInteger (nelem),
 				U" more elements whose sizes are ", Melder_bigInteger (elsize), U" bytes each.");
 	}
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += nelem * elsize;
+	addToCounter (totalNumberOfAllocations, 1);
+	addToCounter (totalAllocationSize, nelem * elsize);
 	return result;
 }
 
@@ -242,36 +258,36 @@ autostring32 Melder_dup_f (conststring32 string /* cattable */) {
 }
 
 int64 Melder_allocationCount () {
-	return totalNumberOfAllocations;
+	return totalNumberOfAllocations.load (std::memory_order_relaxed);
 }
 
 int64 Melder_deallocationCount () {
-	return totalNumberOfDeallocations;
+	return totalNumberOfDeallocations.load (std::memory_order_relaxed);
 }
 
 int64 Melder_allocationSize () {
-	return totalAllocationSize;
+	return totalAllocationSize.load (std::memory_order_relaxed);
 }
 
 int64 Melder_reallocationsInSituCount () {
-	return totalNumberOfReallocsInSitu;
+	return totalNumberOfReallocsInSitu.load (std::memory_order_relaxed);
 }
 
 int64 Melder_movingReallocationsCount () {
-	return totalNumberOfMovingReallocs;
+	return totalNumberOfMovingReallocs.load (std::memory_order_relaxed);
 }
 
 #pragma mark - Generic memory functions for vectors and matrices
 
 namespace MelderArray { // reopen
-	int64 allocationCount = 0, deallocationCount = 0;
-	int64 cellAllocationCount = 0, cellDeallocationCount = 0;
+	static std::atomic <int64> allocationCount (0), deallocationCount (0);
+	static std::atomic <int64> cellAllocationCount (0), cellDeallocationCount (0);
 }
 
-int64 MelderArray_allocationCount () { return MelderArray :: allocationCount; }
-int64 MelderArray_deallocationCount () { return MelderArray :: deallocationCount; }
-int64 MelderArray_cellAllocationCount () { return MelderArray :: cellAllocationCount; }
-int64 MelderArray_cellDeallocationCount () { return MelderArray :: cellDeallocationCount; }
+int64 MelderArray_allocationCount () { return MelderArray :: allocationCount.load (std::memory_order_relaxed); }
+int64 MelderArray_deallocationCount () { return MelderArray :: deallocationCount.load (std::memory_order_relaxed); }
+int64 MelderArray_cellAllocationCount () { return MelderArray :: cellAllocationCount.load (std::memory_order_relaxed); }
+int64 MelderArray_cellDeallocationCount () { return MelderArray :: cellDeallocationCount.load (std::memory_order_relaxed); }
 
 byte * MelderArray:: _alloc_generic (integer cellSize, integer numberOfCells, kInitializationType initializationType) {
 	try {
@@ -280,20 +296,98 @@ byte * MelderArray:: _alloc_generic (integer cellSize, integer numberOfCells, kI
 		byte *result = ( initializationType == kInitializationType :: ZERO ?
 				reinterpret_cast <byte *> (_Melder_calloc (numberOfCells, cellSize)) :
 				reinterpret_cast <byte *> (_Melder_malloc (numberOfCells * cellSize)) );
-		MelderArray::allocationCount += 1;
-		MelderArray::cellAllocationCount += numberOfCells;
+		addToCounter (MelderArray::allocationCount, 1);
+		addToCounter (MelderArray::cellAllocationCount, numberOfCells);
 		return result;
 	} catch (MelderError) {
 		Melder_throw (U"Tensor of ", numberOfCells, U" cells not created.");
 	}
 }
 
+/*
+	Mapped cells are recognized by their address when they are freed.
+	The count of mapped regions makes sure that freeing ordinary cells never has to take the lock.
+*/
+struct MappedRegion {
+	void *address;
+	size_t size;
+};
+static std::mutex theMappedRegionsMutex;
+static std::unordered_map <byte *, MappedRegion> theMappedRegions;   // from the first cell to the mapping
+static std::atomic <integer> theNumberOfMappedRegions (0);
+
+byte * MelderArray:: _map_generic (FILE *f, int64 offset, integer cellSize, integer numberOfCells) {
+	try {
+		if (numberOfCells <= 0)
+			return nullptr;   // not an error
+		Melder_assert (offset >= 0);
+		const int64 numberOfBytes = int64 (cellSize) * numberOfCells;
+		#if defined (UNIX) || defined (macintosh)
+			const int fileDescriptor = fileno (f);
+			struct stat fileStatus;
+			if (fstat (fileDescriptor, & fileStatus) != 0)
+				Melder_throw (U"Cannot determine the size of the file.");
+			/*
+				Touching a mapped page beyond the end of the file would crash,
+				so a truncated file has to be detected now.
+			*/
+			Melder_require (int64 (fileStatus.st_size) >= offset + numberOfBytes,
+				U"The file is too short: it has ", int64 (fileStatus.st_size), U" bytes, but should have at least ",
+				offset + numberOfBytes, U".");
+			const int64 pageSize = sysconf (_SC_PAGESIZE);
+			const int64 pageOffset = offset - offset % pageSize;   // mappings have to start at a page boundary
+			const size_t mappingSize = size_t (offset - pageOffset + numberOfBytes);
+			void *mapping = mmap (nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, off_t (pageOffset));
+			if (mapping == MAP_FAILED)
+				Melder_throw (U"Cannot map the file into memory.");
+			byte *result = reinterpret_cast <byte *> (mapping) + (offset - pageOffset);
+			try {
+				std::lock_guard <std::mutex> lock (theMappedRegionsMutex);
+				theMappedRegions [result] = { mapping, mappingSize };
+			} catch (...) {
+				munmap (mapping, mappingSize);
+				Melder_throw (U"Cannot register the mapping.");
+			}
+			theNumberOfMappedRegions += 1;
+			addToCounter (MelderArray::allocationCount, 1);
+			addToCounter (MelderArray::cellAllocationCount, numberOfCells);
+		#else
+			Melder_require (offset <= INT32_MAX,
+				U"The data start too far into the file.");
+			byte *result = _alloc_generic (cellSize, numberOfCells, kInitializationType::RAW);
+			if (fseek (f, long (offset), SEEK_SET) != 0 ||
+				fread (result, 1, size_t (numberOfBytes), f) != size_t (numberOfBytes))
+			{
+				_free_generic (result, numberOfCells);
+				Melder_throw (U"The file is too short.");
+			}
+		#endif
+		return result;
+	} catch (MelderError) {
+		Melder_throw (U"Tensor of ", numberOfCells, U" cells not mapped from file.");
+	}
+}
+
 void MelderArray:: _free_generic (byte *cells, integer numberOfCells) noexcept {
 	if (! cells)
 		return;   // not an error
+	#if defined (UNIX) || defined (macintosh)
+		if (theNumberOfMappedRegions > 0) {
+			std::lock_guard <std::mutex> lock (theMappedRegionsMutex);
+			auto region = theMappedRegions. find (cells);
+			if (region != theMappedRegions. end ()) {
+				munmap (region -> second. address, region -> second. size);
+				theMappedRegions. erase (region);
+				theNumberOfMappedRegions -= 1;
+				addToCounter (MelderArray::deallocationCount, 1);
+				addToCounter (MelderArray::cellDeallocationCount, numberOfCells);
+				return;
+			}
+		}
+	#endif
 	Melder_free (cells);
-	MelderArray::deallocationCount += 1;
-	MelderArray::cellDeallocationCount += numberOfCells;
+	addToCounter (MelderArray::deallocationCount, 1);
+	addToCounter (MelderArray::cellDeallocationCount, numberOfCells);
 }
 
 /* End of file melder_alloc.cpp */
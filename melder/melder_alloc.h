@@ -82,6 +82,22 @@ namespace MelderArray {
 		return result;
 	}
 
+	byte * _map_generic (FILE *f, int64 offset, integer cellSize, integer numberOfCells);
+	/*
+		Maps the `numberOfCells` cells that start at byte `offset` of the open file `f` into memory.
+		The mapping is lazy (a page is read from disk only when it is touched)
+		and private (a page that is changed is copied first, so that the file never changes).
+		On systems without memory mapping, the cells are simply read.
+		The result is freed with _free_generic (), just like the result of _alloc_generic ();
+		it stays valid after `f` has been closed.
+	*/
+
+	template <class T>
+	T* _map (FILE *f, int64 offset, integer numberOfCells) {
+		T* result = reinterpret_cast <T*> (MelderArray:: _map_generic (f, offset, sizeof (T), numberOfCells));
+		return result;
+	}
+
 	template <class T>
 	void _free (T* cells, integer numberOfCells) noexcept {
 		_free_generic (reinterpret_cast <byte *> (cells), numberOfCells);
@@ -144,7 +144,7 @@ double Melder_atof (conststring32 string) {
 		return undefined;
 	const integer numberOfCharacters = endOfNumericString - & string [0];
 	Melder_assert (numberOfCharacters > 0);
-	static MelderString buffer;
+	static thread_local MelderString buffer;
 	MelderString_ncopy (& buffer, string, numberOfCharacters);
 	const char *string8 = Melder_peek32to8 (buffer.string);
 	const integer string8length = Melder8_length (string8);
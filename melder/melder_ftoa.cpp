@@ -25,9 +25,13 @@
 #define MAXIMUM_NUMERIC_STRING_LENGTH  800
 	/* = sign + 324 + point + 60 + e + sign + 3 + null byte + ("·10^^" - "e"), times 2, + i, + 7 extra */
 
-static char   buffers8  [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
-static char32 buffers32 [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
-static int ibuffer = 0;
+/*
+	The buffers are per thread, so that numbers can be converted to text
+	from within the threads of a multi-threaded analysis.
+*/
+static thread_local char   buffers8  [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
+static thread_local char32 buffers32 [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
+static thread_local int ibuffer = 0;
 
 #define CONVERT_BUFFER_TO_CHAR32 \
 	char32 *q = buffers32 [ibuffer]; \
@@ -480,8 +484,8 @@ conststring32 Melder_colour (MelderColour colour) {
 /********** TENSOR TO STRING CONVERSION **********/
 
 #define NUMBER_OF_TENSOR_BUFFERS  3
-static MelderString theTensorBuffers [NUMBER_OF_TENSOR_BUFFERS];
-static int iTensorBuffer { 0 };
+static thread_local MelderString theTensorBuffers [NUMBER_OF_TENSOR_BUFFERS];
+static thread_local int iTensorBuffer { 0 };
 
 conststring32 Melder_VEC (constVECVU const& value, const bool horizontal) {
 	if (++ iTensorBuffer == NUMBER_OF_TENSOR_BUFFERS)
@@ -524,8 +528,8 @@ conststring32 Melder_STRVEC (constSTRVEC const& value) {
 
 /********** STRING TO STRING CONVERSION **********/
 
-static MelderString thePadBuffers [NUMBER_OF_BUFFERS];
-static int iPadBuffer { 0 };
+static thread_local MelderString thePadBuffers [NUMBER_OF_BUFFERS];
+static thread_local int iPadBuffer { 0 };
 
 conststring32 Melder_pad (int64 width, conststring32 string) {
 	if (++ iPadBuffer == NUMBER_OF_BUFFERS)
@@ -18,8 +18,16 @@
 
 #include "melder.h"
 #include "../kar/UnicodeData.h"
+#include <atomic>
 
-static int64 totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0, totalDeallocationSize = 0;
+/*
+	Atomic, because strings are also allocated from worker threads; relaxed ordering suffices for statistics.
+*/
+static std::atomic <int64> totalNumberOfAllocations (0), totalNumberOfDeallocations (0), totalAllocationSize (0), totalDeallocationSize (0);
+
+static inline void addToCounter (std::atomic <int64> & counter, int64 increment) {
+	counter.fetch_add (increment, std::memory_order_relaxed);
+}
 
 void MelderString16_free (MelderString16 *me) {
 	if (! my string) {
@@ -29,8 +37,8 @@ void MelderString16_free (MelderString16 *me) {
 	Melder_free (my string);
 	if (Melder_debug == 34)
 		Melder_casual (U"from MelderString_free\t", Melder_pointer (my string), U"\t", my bufferSize, U"\t", sizeof (char16));
-	totalNumberOfDeallocations += 1;
-	totalDeallocationSize += my bufferSize * (int64) sizeof (char16);
+	addToCounter (totalNumberOfDeallocations, 1);
+	addToCounter (totalDeallocationSize, my bufferSize * (int64) sizeof (char16));
 	my bufferSize = 0;
 	my length = 0;
 }
@@ -43,8 +51,8 @@ void MelderString_free (MelderString *me) {
 	Melder_free (my string);
 	if (Melder_debug == 34)
 		Melder_casual (U"from MelderString_free\t", Melder_pointer (my string), U"\t", my bufferSize, U"\t", sizeof (char32));
-	totalNumberOfDeallocations += 1;
-	totalDeallocationSize += my bufferSize * (int64) sizeof (char32);
+	addToCounter (totalNumberOfDeallocations, 1);
+	addToCounter (totalDeallocationSize, my bufferSize * (int64) sizeof (char32));
 	my bufferSize = 0;
 	my length = 0;
 }
@@ -56,8 +64,8 @@ inline static void MelderString_expand_ (STRING_TYPE *me, int64 sizeNeeded) {
 	sizeNeeded = (int64) (2.0 /*1.618034*/ * sizeNeeded) + 100;
 	Melder_assert (sizeNeeded > 0);
 	if (my string) {
-		totalNumberOfDeallocations += 1;
-		totalDeallocationSize += my bufferSize * (int64) sizeof (CHARACTER_TYPE);
+		addToCounter (totalNumberOfDeallocations, 1);
+		addToCounter (totalDeallocationSize, my bufferSize * (int64) sizeof (CHARACTER_TYPE));
 	}
 	int64 bytesNeeded = sizeNeeded * (integer) sizeof (CHARACTER_TYPE);
 	Melder_assert (bytesNeeded > 0);
@@ -72,8 +80,8 @@ inline static void MelderString_expand_ (STRING_TYPE *me, int64 sizeNeeded) {
 		my length = 0;
 		throw;
 	}
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += bytesNeeded;
+	addToCounter (totalNumberOfAllocations, 1);
+	addToCounter (totalAllocationSize, bytesNeeded);
 }
 
 void _private_MelderString_expand (MelderString *me, int64 sizeNeeded) {
@@ -207,19 +215,19 @@ void MelderString_truncate (MelderString *const me, const integer maximumLength)
 }
 
 int64 MelderString_allocationCount () {
-	return totalNumberOfAllocations;
+	return totalNumberOfAllocations.load (std::memory_order_relaxed);
 }
 
 int64 MelderString_deallocationCount () {
-	return totalNumberOfDeallocations;
+	return totalNumberOfDeallocations.load (std::memory_order_relaxed);
 }
 
 int64 MelderString_allocationSize () {
-	return totalAllocationSize;
+	return totalAllocationSize.load (std::memory_order_relaxed);
 }
 
 int64 MelderString_deallocationSize () {
-	return totalDeallocationSize;
+	return totalDeallocationSize.load (std::memory_order_relaxed);
 }
 
 MelderString MelderCat::_buffers [MelderCat::_k_NUMBER_OF_BUFFERS] { };
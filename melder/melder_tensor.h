@@ -849,6 +849,21 @@ template <typename T>
 automatrix<T> newmatrixzero (integer nrow, integer ncol) {
 	return automatrix<T> (nrow, ncol, MelderArray::kInitializationType::ZERO);
 }
+/*
+	A matrix whose cells (row after row) are mapped from an open file, starting at byte `offset`;
+	see MelderArray::_map_generic () for what that means.
+*/
+template <typename T>
+automatrix<T> newmatrixmapped (FILE *f, int64 offset, integer nrow, integer ncol) {
+	Melder_assert (nrow >= 0 && ncol >= 0);
+	automatrix<T> result;
+	if (nrow > 0 && ncol > 0) {
+		T *cells = MelderArray:: _map <T> (f, offset, nrow * ncol);
+		result. adoptFromAmbiguousOwner (matrix<T> (cells, nrow, ncol));
+	} else
+		result. adoptFromAmbiguousOwner (matrix<T> (nullptr, nrow, ncol));
+	return result;
+}
 template <typename T>
 void matrixcopy (matrixview<T> const& target, constmatrixview<T> const& source) {
 	Melder_assert (source.nrow == target.nrow && source.ncol == target.ncol);
@@ -1396,6 +1411,9 @@ inline autoMAT raw_MAT (integer nrow, integer ncol) {
 inline autoMAT zero_MAT (integer nrow, integer ncol) {
 	return newmatrixzero <double> (nrow, ncol);
 }
+inline autoMAT mapped_MAT (FILE *f, int64 offset, integer nrow, integer ncol) {
+	return newmatrixmapped <double> (f, offset, nrow, ncol);
+}
 inline autoMAT copy_MAT (constMATVU const& source) {
 	return newmatrixcopy (source);
 }
@@ -20,6 +20,45 @@
 
 /*** Typed I/O functions for vectors and matrices. ***/
 
+/*
+	Binary reading and writing of a stretch of consecutive numbers (a vector, or all the cells of a matrix).
+	For real numbers, abcio reads or writes the whole stretch at once.
+*/
+#define FUNCTION(T,storage)  \
+	static void readBinaryStretch_##storage (const vector<T>& stretch, FILE *f) { \
+		for (integer i = 1; i <= stretch.size; i ++) \
+			stretch [i] = binget##storage (f); \
+	} \
+	static void writeBinaryStretch_##storage (const constvector<T>& stretch, FILE *f) { \
+		for (integer i = 1; i <= stretch.size; i ++) \
+			binput##storage (stretch [i], f); \
+	}
+FUNCTION (signed char, i8)
+FUNCTION (int, i16)
+FUNCTION (long, i32)
+FUNCTION (integer, integer32BE)
+FUNCTION (integer, integer16BE)
+FUNCTION (unsigned char, u8)
+FUNCTION (unsigned int, u16)
+FUNCTION (unsigned long, u32)
+FUNCTION (dcomplex, c64)
+FUNCTION (dcomplex, c128)
+FUNCTION (bool, eb)
+#undef FUNCTION
+static void readBinaryStretch_r32 (VEC const& stretch, FILE *f) {
+	bingetr32 (stretch, f);
+}
+static void writeBinaryStretch_r32 (constVEC const& stretch, FILE *f) {
+	for (integer i = 1; i <= stretch.size; i ++)
+		binputr32 (stretch [i], f);
+}
+static void readBinaryStretch_r64 (VEC const& stretch, FILE *f) {
+	bingetr64 (stretch, f);
+}
+static void writeBinaryStretch_r64 (constVEC const& stretch, FILE *f) {
+	binputr64 (stretch, f);
+}
+
 #define FUNCTION(T,storage)  \
 	void vector_writeText_##storage (const constvector<T>& vec, MelderFile file, conststring32 name) { \
 		texputintro (file, name, U" []: ", vec.size >= 1 ? nullptr : U"(empty)", 0,0,0); \
@@ -29,8 +68,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void vector_writeBinary_##storage (const constvector<T>& vec, FILE *f) { \
-		for (integer i = 1; i <= vec.size; i ++) \
-			binput##storage (vec [i], f); \
+		writeBinaryStretch_##storage (vec, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	autovector<T> vector_readText_##storage (integer size, MelderReadText text, const char *name) { \
@@ -46,9 +84,7 @@
 	} \
 	autovector<T> vector_readBinary_##storage (integer size, FILE *f) { \
 		autovector<T> result = newvectorzero<T> (size); \
-		for (integer i = 1; i <= size; i ++) { \
-			result [i] = binget##storage (f); \
-		} \
+		readBinaryStretch_##storage (result.get(), f); \
 		return result; \
 	} \
 	void matrix_writeText_##storage (const constmatrix<T>& mat, MelderFile file, conststring32 name) { \
@@ -64,10 +100,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void matrix_writeBinary_##storage (const constmatrix<T>& mat, FILE *f) { \
-		for (integer irow = 1; irow <= mat.nrow; irow ++) { \
-			for (integer icol = 1; icol <= mat.ncol; icol ++) \
-				binput##storage (mat [irow] [icol], f); \
-		} \
+		writeBinaryStretch_##storage (mat.asvector (), f);   /* the rows of a matrix are contiguous */ \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	automatrix<T> matrix_readText_##storage (integer nrow, integer ncol, MelderReadText text, const char *name) { \
@@ -83,8 +116,7 @@
 	} \
 	automatrix<T> matrix_readBinary_##storage (integer nrow, integer ncol, FILE *f) { \
 		automatrix<T> result = newmatrixzero<T> (nrow, ncol); \
-		for (integer irow = 1; irow <= nrow; irow ++) for (integer icol = 1; icol <= ncol; icol ++) \
-			result [irow] [icol] = binget##storage (f); \
+		readBinaryStretch_##storage (result.get().asvector (), f); \
 		return result; \
 	} \
 	void tensor3_writeText_##storage (const consttensor3<T>& ten3, MelderFile file, conststring32 name) { \
@@ -200,8 +200,8 @@ int64 Melder_length_utf16 (conststring32 string, bool nativizeNewlines) {
 conststring32 Melder_peek8to32 (conststring8 textA) {
 	if (! textA)
 		return nullptr;
-	static MelderString buffers [19];
-	static int ibuffer = 0;
+	static thread_local MelderString buffers [19];   // per thread, like all the "peek" buffers
+	static thread_local int ibuffer = 0;
 	if (++ ibuffer == 11)
 		ibuffer = 0;
 	MelderString_empty (& buffers [ibuffer]);
@@ -434,8 +434,8 @@ autostring32 Melder_8to32 (const char *string) {
 conststring32 Melder_peek16to32 (conststring16 text) {
 	if (! text)
 		return nullptr;
-	static MelderString buffers [19];
-	static int bufferNumber = 0;
+	static thread_local MelderString buffers [19];
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	MelderString_empty (& buffers [bufferNumber]);
@@ -501,9 +501,9 @@ void Melder_32to8_inplace (conststring32 string, mutablestring8 utf8) {;
 conststring8 Melder_peek32to8 (conststring32 text) {
 	if (! text)
 		return nullptr;
-	static mutablestring8 buffers [19] { nullptr };
-	static int64 bufferSizes [19] { 0 };
-	static int bufferNumber = 0;
+	static thread_local mutablestring8 buffers [19] { nullptr };
+	static thread_local int64 bufferSizes [19] { 0 };
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	constexpr int64 maximumNumberOfUTF8bytesPerUTF32point = 4;   // becausse we use only the lower 21 bits
@@ -533,8 +533,8 @@ autostring8 Melder_32to8 (conststring32 string) {
 conststring16 Melder_peek32to16 (conststring32 text, bool nativizeNewlines) {
 	if (! text)
 		return nullptr;
-	static MelderString16 buffers [19] { };
-	static int bufferNumber = 0;
+	static thread_local MelderString16 buffers [19] { };
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	MelderString16_empty (& buffers [bufferNumber]);
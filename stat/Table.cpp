@@ -20,6 +20,8 @@
 #include "NUM2.h"
 #include "Formula.h"
 #include "SSCP.h"
+#include "MelderThread.h"
+#include <atomic>
 
 #include "oo_DESTROY.h"
 #include "Table_def.h"
@@ -361,13 +363,7 @@ void Table_setNumericValue (Table me, integer rowNumber, integer columnNumber, d
 	}
 }
 
-bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
-	if (rowNumber < 1 || rowNumber > my rows.size)
-		return false;
-	if (columnNumber < 1 || columnNumber > my numberOfColumns)
-		return false;
-	const TableRow row = my rows.at [rowNumber];
-	conststring32 cell = row -> cells [columnNumber]. string.get();
+static bool isCellStringNumeric (conststring32 cell) {
 	if (! cell)
 		return true;   // namely the value --undefined--
 	/*
@@ -387,6 +383,20 @@ bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer column
 	return Melder_isStringNumeric (cell);
 }
 
+static double cellStringToNumber (conststring32 string) {   // only for strings that are numeric
+	return ! string || string [0] == U'\0' || (string [0] == U'?' && string [1] == U'\0') ? undefined :
+			Melder_atof (string);
+}
+
+bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
+	if (rowNumber < 1 || rowNumber > my rows.size)
+		return false;
+	if (columnNumber < 1 || columnNumber > my numberOfColumns)
+		return false;
+	const TableRow row = my rows.at [rowNumber];
+	return isCellStringNumeric (row -> cells [columnNumber]. string.get());
+}
+
 bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	if (columnNumber < 1 || columnNumber > my numberOfColumns)
 		return false;
@@ -396,23 +406,32 @@ bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	return true;
 }
 
-static void sortRowsByStrings_a (Table me, integer columnNumber) {
-	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
-	std::sort (my rows.begin(), my rows.end(),
-		[columnNumber] (TableRow she, TableRow him) {
-			const conststring32 firstString = her cells [columnNumber]. string.get();
-			const conststring32 secondString = his cells [columnNumber]. string.get();
-			return str32cmp (firstString ? firstString : U"", secondString ? secondString : U"") < 0;
+static void sortRowsByIndex_NoError (Table me) {
+	/*
+		The sorting indexes are a permutation of 1 .. my rows.size,
+		so every row can be put into place directly, by following the cycles of the permutation.
+	*/
+	for (integer irow = 1; irow <= my rows.size; irow ++) {
+		while (my rows.at [irow] -> sortingIndex != irow) {
+			const integer targetRow = my rows.at [irow] -> sortingIndex;
+			Melder_assert (targetRow >= 1 && targetRow <= my rows.size);
+			std::swap (my rows.at [irow], my rows.at [targetRow]);
 		}
-	);
+	}
 }
 
-static void sortRowsByIndex_NoError (Table me) {
-	std::sort (my rows.begin(), my rows.end(),
-		[] (TableRow she, TableRow him) {
-			return her sortingIndex < his sortingIndex;
-		}
-	);
+/*
+	Sorting the rows themselves, with comparisons that reach through two pointers into every cell,
+	is slow for large tables. Instead, we sort row numbers by keys that have been copied
+	into contiguous memory, and then move each row only once.
+*/
+static void Table_permuteRows (Table me, constINTVEC const& permutation) {   // new row i := old row permutation [i]
+	Melder_assert (permutation.size == my rows.size);
+	autovector <TableRow> oldRows = newvectorraw <TableRow> (my rows.size);   // the only thing that can fail
+	for (integer irow = 1; irow <= my rows.size; irow ++)
+		oldRows [irow] = my rows.at [irow];
+	for (integer irow = 1; irow <= my rows.size; irow ++)
+		my rows.at [irow] = oldRows [permutation [irow]];   // the sorting indexes are left alone
 }
 
 void Table_numericize_a (Table me, integer columnNumber) {
@@ -422,30 +441,33 @@ void Table_numericize_a (Table me, integer columnNumber) {
 	if (Table_isColumnNumeric_ErrorFalse (me, columnNumber)) {
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			TableRow row = my rows.at [irow];
-			const conststring32 string = row -> cells [columnNumber]. string.get();
-			row -> cells [columnNumber]. number =
-					! string || string [0] == U'\0' || (string [0] == U'?' && string [1] == U'\0') ? undefined :
-					Melder_atof (string);
+			row -> cells [columnNumber]. number = cellStringToNumber (row -> cells [columnNumber]. string.get());
 		}
 	} else {
+		/*
+			Dictionary encoding: each cell gets the rank of its string among the distinct strings of the column.
+		*/
+		const integer numberOfRows = my rows.size;
+		autovector <conststring32> strings = newvectorraw <conststring32> (numberOfRows);
+		for (integer irow = 1; irow <= numberOfRows; irow ++) {
+			const conststring32 string = my rows.at [irow] -> cells [columnNumber]. string.get();
+			strings [irow] = ( string ? string : U"" );
+		}
+		autoINTVEC order = to_INTVEC (numberOfRows);
+		std::sort (order.begin(), order.end(),
+			[& strings] (integer irow, integer jrow) {
+				return str32cmp (strings [irow], strings [jrow]) < 0;
+			}
+		);
 		integer iunique = 0;
 		conststring32 previousString = nullptr;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		sortRowsByStrings_a (me, columnNumber);
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			conststring32 string = row -> cells [columnNumber]. string.get();
-			if (! string)
-				string = U"";
-			if (! previousString || ! str32equ (string, previousString))
+		for (integer i = 1; i <= numberOfRows; i ++) {
+			const integer irow = order [i];
+			if (! previousString || ! str32equ (strings [irow], previousString))
 				iunique ++;
-			row -> cells [columnNumber]. number = iunique;
-			previousString = string;
+			my rows.at [irow] -> cells [columnNumber]. number = iunique;
+			previousString = strings [irow];
 		}
-		sortRowsByIndex_NoError (me);
 	}
 	my columnHeaders [columnNumber]. numericized = true;
 }
@@ -1111,18 +1133,27 @@ autoTable Table_transpose (Table me) {
 void Table_sortRows_a (Table me, constINTVECVU const& columnNumbers) {
 	for (integer icol = 1; icol <= columnNumbers.size; icol ++)
 		Table_numericize_a (me, columnNumbers [icol]);
-	std::sort (my rows.begin(), my rows.end(),
-		[columnNumbers] (TableRow she, TableRow him) -> bool {
-			for (integer icol = 1; icol <= columnNumbers.size; icol ++) {
-				const integer cellNumber = columnNumbers [icol];
-				if (her cells [cellNumber]. number < his cells [cellNumber]. number)
+	const integer numberOfRows = my rows.size, numberOfKeys = columnNumbers.size;
+	autoMAT keys = raw_MAT (numberOfRows, numberOfKeys);
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const constTableRow row = my rows.at [irow];
+		for (integer ikey = 1; ikey <= numberOfKeys; ikey ++)
+			keys [irow] [ikey] = row -> cells [columnNumbers [ikey]]. number;
+	}
+	autoINTVEC permutation = to_INTVEC (numberOfRows);
+	std::stable_sort (permutation.begin(), permutation.end(),
+		[& keys, numberOfKeys] (integer irow, integer jrow) -> bool {
+			const double * const iKeys = & keys [irow] [1], * const jKeys = & keys [jrow] [1];
+			for (integer ikey = 0; ikey < numberOfKeys; ikey ++) {
+				if (iKeys [ikey] < jKeys [ikey])
 					return true;
-				if (her cells [cellNumber]. number > his cells [cellNumber]. number)
+				if (iKeys [ikey] > jKeys [ikey])
 					return false;
 			}
 			return false;
 		}
 	);
+	Table_permuteRows (me, permutation.get());
 }
 
 void Table_sortRows (Table me, constSTRVEC columnNames) {
@@ -1338,11 +1369,67 @@ void Table_appendQuotientColumn (Table me, integer column1, integer column2, con
 	}
 }
 
+/*
+	A formula that reads nothing but the current row can be run on different rows at the same time,
+	as long as every row is handled by a single thread, from left to right.
+	If anything goes wrong, all cells are put back, and the caller runs the formula again in the old way,
+	which gives the same error message and leaves the same partially changed table as before.
+*/
+static bool Table_formula_columnRange_inParallel (Table me, integer fromColumn, integer toColumn) {
+	const integer numberOfRows = my rows.size, numberOfColumnsInRange = toColumn - fromColumn + 1;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfRows * numberOfColumnsInRange, 1000);
+	if (numberOfThreads < 2)
+		return false;
+	autoSTRVEC originalStrings (numberOfRows * numberOfColumnsInRange);
+	autoBOOLVEC cellHasChanged = zero_BOOLVEC (numberOfRows * numberOfColumnsInRange);
+	try {
+		MelderThread_runChunked (numberOfThreads, numberOfRows, 0,
+			[&] (integer /* ithread */, integer fromRow, integer toRow) {
+				Formula_Result result;
+				for (integer irow = fromRow; irow <= toRow; irow ++) {
+					TableRow row = my rows.at [irow];
+					for (integer icol = fromColumn; icol <= toColumn; icol ++) {
+						Formula_run (irow, icol, & result);
+						autostring32 newString;
+						if (result. expressionType == kFormula_EXPRESSION_TYPE_STRING)
+							newString = Melder_dup (result. stringResult.get());
+						else if (result. expressionType == kFormula_EXPRESSION_TYPE_NUMERIC)
+							newString = Melder_dup (Melder_double (result. numericResult));
+						else
+							Melder_throw (me, U": cannot put ", result. expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR ? U"vectors" :
+									result. expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX ? U"matrices" : U"string arrays", U" into cells.");
+						const integer icell = (irow - 1) * numberOfColumnsInRange + (icol - fromColumn + 1);
+						originalStrings [icell] = row -> cells [icol]. string.move();
+						cellHasChanged [icell] = true;
+						row -> cells [icol]. string = newString.move();
+					}
+				}
+			}
+		);
+	} catch (MelderError) {
+		Melder_clearError ();
+		for (integer irow = 1; irow <= numberOfRows; irow ++) {
+			TableRow row = my rows.at [irow];
+			for (integer icol = fromColumn; icol <= toColumn; icol ++) {
+				const integer icell = (irow - 1) * numberOfColumnsInRange + (icol - fromColumn + 1);
+				if (cellHasChanged [icell])
+					row -> cells [icol]. string = originalStrings [icell].move();
+			}
+		}
+		return false;
+	}
+	for (integer icol = fromColumn; icol <= toColumn; icol ++)
+		my columnHeaders [icol]. numericized = false;
+	return true;
+}
+
 void Table_formula_columnRange (Table me, integer fromColumn, integer toColumn, conststring32 expression, Interpreter interpreter) {
 	try {
 		Table_checkSpecifiedColumnNumberWithinRange (me, fromColumn);
 		Table_checkSpecifiedColumnNumberWithinRange (me, toColumn);
 		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, true);
+		if (Formula_canRunInParallel () && Table_formula_columnRange_inParallel (me, fromColumn, toColumn))
+			return;
 		Formula_Result result;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			for (integer icol = fromColumn; icol <= toColumn; icol ++) {
@@ -2092,8 +2179,47 @@ void Table_writeToSemicolonSeparatedFile (Table me, MelderFile file) {
 	}
 }
 
+/*
+	Tables of several gigabytes are read in two passes over the text.
+	The first pass is serial and only looks for the places where the rows start,
+	which is cheap. In the second pass, the rows are divided among threads,
+	each of which copies the cells of its own rows and checks on the fly whether they are numeric.
+	Columns of which all cells turn out to be numeric come out numericized,
+	so that a subsequent analysis does not have to parse the strings again.
+*/
+static void TableCell_setParsedString (TableCell cell, autostring32 string, bool *inout_columnHasNonnumericCells) {
+	if (! *inout_columnHasNonnumericCells) {
+		if (isCellStringNumeric (string.get()))
+			cell -> number = cellStringToNumber (string.get());
+		else
+			*inout_columnHasNonnumericCells = true;   // from now on, the numbers will have to come from Table_numericize_a
+	}
+	cell -> string = string.move();
+}
+
+static integer Table_computeNumberOfReadingThreads (Table me) {
+	return MelderThread_computeNumberOfThreads (my rows.size, 1 + 20000 / my numberOfColumns);
+}
+
+static void Table_numericizeParsedColumns (Table me, constBOOLMAT const& columnHasNonnumericCells) {
+	for (integer icol = 1; icol <= my numberOfColumns; icol ++) {
+		bool isNumeric = true;
+		for (integer ithread = 1; ithread <= columnHasNonnumericCells.nrow; ithread ++)
+			if (columnHasNonnumericCells [ithread] [icol])
+				isNumeric = false;
+		my columnHeaders [icol]. numericized = isNumeric;
+	}
+}
+
+static void traceReadingSpeed (MelderFile file, double startingTime) {
+	const double duration = Melder_clock () - startingTime;
+	trace (U"read ", MelderFile_length (file), U" bytes in ", duration, U" seconds (",
+			MelderFile_length (file) / 1e6 / std::max (duration, 1e-9), U" MB/s)");
+}
+
 autoTable Table_readFromTableFile (MelderFile file) {
 	try {
+		const double startingTime = Melder_clock ();
 		autostring32 string = MelderFile_readText (file);
 		/*
 			Count columns.
@@ -2144,37 +2270,53 @@ autoTable Table_readFromTableFile (MelderFile file) {
 		autoTable me = Table_create (numberOfRows, numberOfColumns);
 
 		/*
-			Read elements.
+			Find the elements. A row does not have to be on a single line,
+			so a row starts wherever its first element starts.
 		*/
+		autoINTVEC elementStarts = raw_INTVEC (numberOfElements);   // offsets into the string
 		p = & string [0];
-		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-			while (*p == U' ' || *p == U'\t') {
-				Melder_assert (*p != U'\0');
+		for (integer ielement = 1; ielement <= numberOfElements; ielement ++) {
+			while (*p == U' ' || *p == U'\t' || *p == U'\n')
 				p ++;
-			}
-			static MelderString buffer;
-			MelderString_empty (& buffer);
-			while (*p != U' ' && *p != U'\t' && *p != U'\n') {
-				MelderString_appendCharacter (& buffer, *p);
-				p ++;
-			}
-			Table_renameColumn_e (me.get(), icol, buffer.string);
-			MelderString_empty (& buffer);
+			Melder_assert (*p != U'\0');
+			elementStarts [ielement] = p - & string [0];
+			do { p ++; } while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0');
 		}
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				while (*p == U' ' || *p == U'\t' || *p == U'\n') { Melder_assert (*p != U'\0'); p ++; }
-				static MelderString buffer;
-				MelderString_empty (& buffer);
-				while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0') {
-					MelderString_appendCharacter (& buffer, *p);
-					p ++;
+		auto elementLength = [&] (integer ielement) -> integer {
+			const char32 *start = & string [elementStarts [ielement]], *q = start;
+			while (*q != U' ' && *q != U'\t' && *q != U'\n' && *q != U'\0')
+				q ++;
+			return q - start;
+		};
+
+		/*
+			Read column names.
+		*/
+		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+			autostring32 label = Melder_ndup (& string [elementStarts [icol]], elementLength (icol));
+			Table_renameColumn_e (me.get(), icol, label.get());
+		}
+
+		/*
+			Read cells.
+		*/
+		const integer numberOfThreads = Table_computeNumberOfReadingThreads (me.get());
+		autoBOOLMAT columnHasNonnumericCells = zero_BOOLMAT (numberOfThreads, numberOfColumns);
+		MelderThread_runChunked (numberOfThreads, numberOfRows, 0,
+			[&] (integer ithread, integer fromRow, integer toRow) {
+				for (integer irow = fromRow; irow <= toRow; irow ++) {
+					TableRow row = my rows.at [irow];
+					for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+						const integer ielement = irow * numberOfColumns + icol;
+						TableCell_setParsedString (& row -> cells [icol],
+								Melder_ndup (& string [elementStarts [ielement]], elementLength (ielement)),
+								& columnHasNonnumericCells [ithread] [icol]);
+					}
 				}
-				row -> cells [icol]. string = Melder_dup_f (buffer.string);
-				MelderString_empty (& buffer);
 			}
-		}
+		);
+		Table_numericizeParsedColumns (me.get(), columnHasNonnumericCells.get());
+		traceReadingSpeed (file, startingTime);
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from space-separated text file ", file, U".");
@@ -2183,6 +2325,7 @@ autoTable Table_readFromTableFile (MelderFile file) {
 
 autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 separator, bool interpretQuotes) {
 	try {
+		const double startingTime = Melder_clock ();
 		autostring32 string = MelderFile_readText (file);
 
 		/*
@@ -2209,6 +2352,7 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 			if (kar == separator)
 				numberOfColumns ++;
 		}
+		const char32 *firstRow = p;
 
 		/*
 			Count rows.
@@ -2218,17 +2362,34 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 			bool withinQuotes = false;
 			for (;;) {
 				char32 kar = *p++;
+				if (kar == U'\0')
+					break;   // even within quotes
 				if (interpretQuotes && kar == U'\"')
 					withinQuotes = ! withinQuotes;
-				if (! withinQuotes) {
-					if (kar == U'\0')
-						break;
-					if (kar == U'\n')
-						numberOfRows ++;
-				}
+				else if (kar == U'\n' && ! withinQuotes)
+					numberOfRows ++;
 			}
 		}
 
+		/*
+			Find the record boundaries. A new-line symbol within double quotes does not end a record.
+			Element numberOfRows + 1 points to the null byte, so that every row has an end.
+		*/
+		autoINTVEC rowStarts = raw_INTVEC (numberOfRows + 1);   // offsets into the string
+		{// scope
+			rowStarts [1] = firstRow - & string [0];
+			integer irow = 1;
+			bool withinQuotes = false;
+			for (p = firstRow; *p != U'\0'; p ++) {
+				if (interpretQuotes && *p == U'\"')
+					withinQuotes = ! withinQuotes;
+				else if (*p == U'\n' && ! withinQuotes)
+					rowStarts [++ irow] = p + 1 - & string [0];
+			}
+			Melder_assert (irow == numberOfRows);
+			rowStarts [numberOfRows + 1] = p + 1 - & string [0];   // as if there were a new-line symbol in front of the null byte
+		}
+
 		/*
 			Create empty table.
 		*/
@@ -2252,46 +2413,80 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 
 		/*
 			Read cells.
+			Errors in the format are not thrown from within the threads,
+			but are reported afterwards for the first offending row.
 	 	*/
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				MelderString_empty (& buffer);
-				bool withinQuotes = false;
-				while (*p != U'\0' && (*p != separator && *p != U'\n' || withinQuotes)) {
-					if (interpretQuotes && *p == U'\"') {
-						withinQuotes = ! withinQuotes;
-					} else {
-						MelderString_appendCharacter (& buffer, *p);
+		const integer numberOfThreads = Table_computeNumberOfReadingThreads (me.get());
+		autoBOOLMAT columnHasNonnumericCells = zero_BOOLMAT (numberOfThreads, numberOfColumns);
+		std::atomic <integer> firstIncompleteRow (numberOfRows + 1), firstOverfullRow (numberOfRows + 1);
+		bool lastCellHasUnmatchedQuote = false;
+		MelderThread_runChunked (numberOfThreads, numberOfRows, 0,
+			[&] (integer ithread, integer fromRow, integer toRow) {
+				for (integer irow = fromRow; irow <= toRow; irow ++) {
+					TableRow row = my rows.at [irow];
+					const char32 *q = & string [rowStarts [irow]];
+					const char32 * const rowEnd = & string [rowStarts [irow + 1] - 1];   // the new-line symbol or the null byte
+					for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+						if (q > rowEnd) {
+							integer previous = firstIncompleteRow;
+							while (irow < previous && ! firstIncompleteRow. compare_exchange_weak (previous, irow)) { }
+							break;
+						}
+						/*
+							Find the end of the cell, and its length without the quotes.
+						*/
+						const char32 *cellStart = q;
+						integer length = 0;
+						bool withinQuotes = false, cellHasQuotes = false;
+						while (q < rowEnd && (*q != separator || withinQuotes)) {
+							if (interpretQuotes && *q == U'\"') {
+								withinQuotes = ! withinQuotes;
+								cellHasQuotes = true;
+							} else
+								length ++;
+							q ++;
+						}
+						if (withinQuotes && irow == numberOfRows && icol == numberOfColumns)
+							lastCellHasUnmatchedQuote = true;
+						autostring32 cell;
+						if (cellHasQuotes) {
+							cell = autostring32 (length, false);
+							integer icharacter = 0;
+							for (const char32 *r = cellStart; r < q; r ++)
+								if (*r != U'\"')
+									cell [icharacter ++] = *r;
+							cell [length] = U'\0';
+						} else
+							cell = Melder_ndup (cellStart, length);
+						TableCell_setParsedString (& row -> cells [icol], cell.move(), & columnHasNonnumericCells [ithread] [icol]);
+						q ++;   // beyond the separator or the end of the row
 					}
-					p ++;
-				}
-				if (*p == U'\0') {
-					if (irow != numberOfRows)
-						Melder_fatal (U"irow ", irow, U", nrow ", numberOfRows, U", icol ", icol, U", ncol ", numberOfColumns);
-					if (icol != numberOfColumns)
-						Melder_throw (U"Last row incomplete.");
-					if (withinQuotes) {
-						if (str32chr (buffer.string, U'\n'))
-							Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
-									"so perhaps multiple lines were unintentionally combined into one cell. "
-									"The problem may be in row ", irow, U".");
-						else
-							Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
-									"so perhaps multiple cells were unintentionally combined. "
-									"The problem is in row ", irow, U".");
+					if (q <= rowEnd) {
+						integer previous = firstOverfullRow;
+						while (irow < previous && ! firstOverfullRow. compare_exchange_weak (previous, irow)) { }
 					}
-				} else if (*p == U'\n') {
-					if (icol != numberOfColumns)
-						Melder_throw (U"Row ", irow, U" incomplete.");
-					p ++;
-				} else {
-					Melder_assert (*p == separator);
-					p ++;
 				}
-				row -> cells [icol]. string = Melder_dup (buffer.string);   // BUG? could be null
 			}
+		);
+		if (firstIncompleteRow <= numberOfRows) {
+			if (firstIncompleteRow == numberOfRows)
+				Melder_throw (U"Last row incomplete.");
+			Melder_throw (U"Row ", (integer) firstIncompleteRow, U" incomplete.");
+		}
+		if (firstOverfullRow <= numberOfRows)
+			Melder_throw (U"Row ", (integer) firstOverfullRow, U" has more than ", numberOfColumns, U" cells.");
+		if (lastCellHasUnmatchedQuote) {
+			if (str32chr (my rows.at [numberOfRows] -> cells [numberOfColumns]. string.get(), U'\n'))
+				Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
+						"so perhaps multiple lines were unintentionally combined into one cell. "
+						"The problem may be in row ", numberOfRows, U".");
+			else
+				Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
+						"so perhaps multiple cells were unintentionally combined. "
+						"The problem is in row ", numberOfRows, U".");
 		}
+		Table_numericizeParsedColumns (me.get(), columnHasNonnumericCells.get());
+		traceReadingSpeed (file, startingTime);
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from character-separated text file ", file, U".");
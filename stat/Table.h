@@ -66,6 +66,15 @@ void Table_setNumericValue (Table me, integer row, integer column, double value)
 
 /* For optimizations only (e.g. conversion to Matrix or TableOfReal). */
 void Table_numericize_a (Table me, integer columnNumber);
+/*
+	There is no columnar numeric store: the cells are kept row by row, as strings with a number beside them,
+	and Table_getMean, Table_getStdev and the other column statistics still call Table_numericize_a,
+	which parses every string of the column again on every call.
+	Only two operations work on contiguous per-column arrays, and only these got faster:
+	sorting (Table_sortRows_a and its callers, such as Table_sortRows and Table_collapseRows,
+	copy their numeric sort keys into one matrix and move every row only once),
+	and the dictionary encoding of a text column in Table_numericize_a.
+*/
 
 autoVEC Table_getAllNumbersInColumn (Table me, integer columnNumber);
 
@@ -19,6 +19,8 @@
 #if defined (UNIX)
 	#include <sys/stat.h>
 #endif
+#include <memory>
+#include <vector>
 #include "../dwsys/NUM2.h"
 #include "Formula.h"
 #include "Interpreter.h"
@@ -51,9 +53,19 @@ typedef struct structFormulaInstruction {
 	} content;
 } *FormulaInstruction;
 
-static FormulaInstruction lexan, parse;
+static FormulaInstruction lexan, parse, theParseBuffer;
 static integer ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
 
+struct FormulaCompiledExpression {
+	integer numberOfInstructions;
+	std::vector <structFormulaInstruction> instructions;   // a copy of `parse` [0 .. numberOfInstructions + 1]
+	std::vector <autostring32> strings;   // owned by the copy
+};
+static std::unordered_map <Interpreter, std::unordered_map <std::u32string, std::shared_ptr <FormulaCompiledExpression>>> theCompiledExpressions;
+static std::shared_ptr <FormulaCompiledExpression> theCompiledExpression;   // the one that `parse` points into, if any
+static integer theNumberOfCacheHits, theNumberOfCacheMisses, theNumberOfUncacheableExpressions;
+constexpr integer MAXIMUM_NUMBER_OF_CACHED_EXPRESSIONS = 10'000;   // per interpreter
+
 enum { NO_SYMBOL_,
 
 #define DECLARE_WITH_TENSORS(symbol)  \
@@ -2301,8 +2313,10 @@ void Formula_compile (Interpreter interpreter, Daata data, conststring32 express
 		lexan = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
 		lexan [Formula_MAXIMUM_STACK_SIZE - 1]. symbol = END_;   // make sure that cleaning up always terminates
 	}
-	if (! parse)
-		parse = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
+	if (! theParseBuffer)
+		theParseBuffer = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
+	parse = theParseBuffer;   // `parse` may have pointed to a cached expression (see below)
+	theCompiledExpression. reset ();
 
 	/*
 		Clean up strings from the previous call.
@@ -2340,6 +2354,91 @@ void Formula_compile (Interpreter interpreter, Daata data, conststring32 express
 	if (Melder_debug == 17) Formula_print (parse);
 }
 
+/*
+	A script that evaluates the same expression over and over again (typically in a loop)
+	does not have to lex and parse that expression every time.
+	The compiled instructions refer to the variables of the interpreter by pointer,
+	so the cache is kept per interpreter, and is forgotten as soon as the interpreter throws its variables away.
+	Variables are not removed otherwise, and the type of a variable follows from its name,
+	so that a cached expression remains valid as long as the interpreter keeps its variables.
+	Expressions that contain object names (e.g. `Sound_hello[3]` or `Object_17[3]`) are not cached,
+	because their compiled form refers to an object that can be removed.
+*/
+static bool Formula_isCacheable () {
+	for (integer i = 1; lexan [i]. symbol != END_; i ++)
+		if (lexan [i]. symbol == MATRIX_ || lexan [i]. symbol == MATRIX_STR_)
+			return false;
+	return true;
+}
+
+static bool Formula_instructionOwnsString (integer symbol) {
+	return symbol == STRING_ || symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_ || symbol == CALL_;
+}
+
+void Formula_compileWithCache (Interpreter interpreter, conststring32 expression, int expressionType) {
+	if (! interpreter) {
+		Formula_compile (nullptr, nullptr, expression, expressionType, false);   // the local interpreter forgets its variables every time
+		return;
+	}
+	std::u32string key;
+	key += char32 (U'0' + expressionType);
+	key += interpreter -> procedureNames [interpreter -> callDepth];   // because of local variables such as `.x`
+	key += U'\n';
+	key += expression;
+	auto& compiledExpressions = theCompiledExpressions [interpreter];
+	auto it = compiledExpressions. find (key);
+	if (it != compiledExpressions. end ()) {
+		theInterpreter = interpreter;
+		theSource = nullptr;
+		theExpression = expression;
+		theExpressionType [theLevel] = expressionType;
+		theOptimize = false;
+		theCompiledExpression = it -> second;
+		parse = theCompiledExpression -> instructions. data ();
+		numberOfInstructions = theCompiledExpression -> numberOfInstructions;
+		theNumberOfCacheHits += 1;
+		return;
+	}
+	Formula_compile (interpreter, nullptr, expression, expressionType, false);
+	if (! Formula_isCacheable ()) {
+		theNumberOfUncacheableExpressions += 1;
+		return;
+	}
+	if (integer (compiledExpressions. size ()) >= MAXIMUM_NUMBER_OF_CACHED_EXPRESSIONS)
+		compiledExpressions. clear ();   // e.g. a script that substitutes a loop variable into its expressions
+	auto compiledExpression = std::make_shared <FormulaCompiledExpression> ();
+	compiledExpression -> numberOfInstructions = numberOfInstructions;
+	compiledExpression -> instructions. assign (parse, parse + numberOfInstructions + 2);   // including the final END_
+	for (integer i = 1; i <= numberOfInstructions; i ++) {
+		structFormulaInstruction& instruction = compiledExpression -> instructions [uinteger (i)];
+		if (Formula_instructionOwnsString (instruction. symbol)) {
+			/*
+				In `parse`, the string is a reference to a string owned by `lexan`, which will be cleaned up at the next compilation.
+			*/
+			autostring32 string = Melder_dup (instruction. content.string);
+			instruction. content.string = string.get();
+			compiledExpression -> strings. push_back (string.move());
+		}
+	}
+	compiledExpressions [key] = compiledExpression;
+	theNumberOfCacheMisses += 1;
+}
+
+void Formula_forgetCompiledExpressions (Interpreter interpreter) noexcept {
+	theCompiledExpressions. erase (interpreter);
+}
+
+Formula_CacheStatistics Formula_getCacheStatistics () {
+	Formula_CacheStatistics result;
+	result. numberOfHits = theNumberOfCacheHits;
+	result. numberOfMisses = theNumberOfCacheMisses;
+	result. numberOfUncacheableExpressions = theNumberOfUncacheableExpressions;
+	result. numberOfCachedExpressions = 0;
+	for (auto const& [interpreter, compiledExpressions] : theCompiledExpressions)
+		result. numberOfCachedExpressions += integer (compiledExpressions. size ());
+	return result;
+}
+
 /*
 	Running.
 */
@@ -2355,10 +2454,14 @@ conststring32 structStackel :: whichText () {
 		U"???";
 }
 
-static integer programPointer;
+/*
+	The run-time state is per thread, so that a compiled formula can be run from several threads at once
+	(see Formula_canRunInParallel); the compiled instructions themselves are shared.
+*/
+static thread_local integer programPointer;
 
-static Stackel theStack;
-static integer stackPointer, stackPointerMax;
+static thread_local Stackel theStack;
+static thread_local integer stackPointer, stackPointerMax;
 #define pop  & theStack [stackPointer --]
 #define topOfStack  & theStack [stackPointer]
 inline static void pushNumber (const double x) {
@@ -3461,6 +3564,9 @@ static void do_softmaxPerRow_MAT () {
 }
 
 #define DO_NUM_WITH_TENSORS(function, formula, message)  \
+static double num_##function (const double xvalue) { \
+	return formula; \
+} \
 static void do_##function () { \
 	const Stackel x = pop; \
 	if (x->which == Stackel_NUMBER) { \
@@ -8263,6 +8369,7 @@ static double NUMerf (double x) {
 }
 
 void Formula_run (integer row, integer col, Formula_Result *result) {
+	const std::shared_ptr <FormulaCompiledExpression> keepAlive = theCompiledExpression;   // in case the formula compiles other formulas
 	FormulaInstruction f = parse;
 	programPointer = 1;   // first symbol of the program
 	if (! theStack) {
@@ -8862,4 +8969,368 @@ CASE_NUM_WITH_TENSORS (LOG10_, do_log10)
 	}
 }
 
+/*
+	Block programs.
+*/
+
+Thing_implement (FormulaBlockProgram, Thing, 0);
+
+inline static double definedOrUndefined (const double x) {
+	return isdefined (x) ? x : undefined;   // as in pushNumber ()
+}
+
+/*
+	The functions of one number whose results depend only on their arguments,
+	with the same formulas as in do_abs () and the like.
+*/
+static double (*blockFunction1Checked (integer symbol)) (double) {   // the argument is checked for being undefined
+	switch (symbol) {
+		case SINC_: return NUMsinc;
+		case SINCPI_: return NUMsincpi;
+		case ERF_: return NUMerf;
+		case ERFC_: return NUMerfcc;
+		case GAUSS_P_: return NUMgaussP;
+		case GAUSS_Q_: return NUMgaussQ;
+		case INV_GAUSS_Q_: return NUMinvGaussQ;
+		case LN_GAMMA_: return NUMlnGamma;
+		case HERTZ_TO_BARK_: return NUMhertzToBark;
+		case BARK_TO_HERTZ_: return NUMbarkToHertz;
+		case PHON_TO_DIFFERENCE_LIMENS_: return NUMphonToDifferenceLimens;
+		case DIFFERENCE_LIMENS_TO_PHON_: return NUMdifferenceLimensToPhon;
+		case HERTZ_TO_MEL_: return NUMhertzToMel;
+		case MEL_TO_HERTZ_: return NUMmelToHertz;
+		case HERTZ_TO_SEMITONES_: return NUMhertzToSemitones;
+		case SEMITONES_TO_HERTZ_: return NUMsemitonesToHertz;
+		case ERB_: return NUMerb;
+		case HERTZ_TO_ERB_: return NUMhertzToErb;
+		case ERB_TO_HERTZ_: return NUMerbToHertz;
+		default: return nullptr;
+	}
+}
+static double (*blockFunction1Unchecked (integer symbol)) (double) {
+	switch (symbol) {
+		case ABS_: return num_abs;
+		case ROUND_: return num_round;
+		case FLOOR_: return num_floor;
+		case CEILING_: return num_ceiling;
+		case RECTIFY_: return num_rectify;
+		case SQRT_: return num_sqrt;
+		case SIN_: return num_sin;
+		case COS_: return num_cos;
+		case TAN_: return num_tan;
+		case ARCSIN_: return num_arcsin;
+		case ARCCOS_: return num_arccos;
+		case ARCTAN_: return num_arctan;
+		case EXP_: return num_exp;
+		case SINH_: return num_sinh;
+		case COSH_: return num_cosh;
+		case TANH_: return num_tanh;
+		case ARCSINH_: return num_arcsinh;
+		case ARCCOSH_: return num_arccosh;
+		case ARCTANH_: return num_arctanh;
+		case SIGMOID_: return num_sigmoid;
+		case INV_SIGMOID_: return num_invSigmoid;
+		case LOG2_: return num_log2;
+		case LN_: return num_ln;
+		case LOG10_: return num_log10;
+		default: return nullptr;
+	}
+}
+static double (*blockFunction2 (integer symbol)) (double, double) {   // as in do_function_dd_d ()
+	switch (symbol) {
+		case ARCTAN2_: return atan2;
+		case CHI_SQUARE_P_: return NUMchiSquareP;
+		case CHI_SQUARE_Q_: return NUMchiSquareQ;
+		case INCOMPLETE_GAMMAP_: return NUMincompleteGammaP;
+		case INV_CHI_SQUARE_Q_: return NUMinvChiSquareQ;
+		case STUDENT_P_: return NUMstudentP;
+		case STUDENT_Q_: return NUMstudentQ;
+		case INV_STUDENT_Q_: return NUMinvStudentQ;
+		case BETA_: return NUMbeta;
+		case BETA2_: return NUMbeta2;
+		case LN_BETA_: return NUMlnBeta;
+		case SOUND_PRESSURE_TO_PHON_: return NUMsoundPressureToPhon;
+		default: return nullptr;
+	}
+}
+
+/*
+	The change in stack depth caused by an instruction, or `kBlockStackEffect_NOT_ALLOWED` if the instruction
+	is not allowed in a block program.
+*/
+static constexpr integer kBlockStackEffect_NOT_ALLOWED = INTEGER_MIN;
+static integer blockStackEffect (integer symbol) {
+	switch (symbol) {
+		case NUMBER_: case TRUE_: case FALSE_: case ROW_: case COL_: case X_: case Y_: case SELF0_: case NUMERIC_VARIABLE_:
+			return +1;
+		case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case POWER_:
+		case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+		case IFTRUE_: case IFFALSE_:
+			return -1;
+		case NOT_: case MINUS_: case SQR_: case GOTO_: case LABEL_:
+			return 0;
+		default:
+			if (blockFunction1Checked (symbol) || blockFunction1Unchecked (symbol))
+				return 0;
+			if (blockFunction2 (symbol))
+				return -1;
+			return kBlockStackEffect_NOT_ALLOWED;
+	}
+}
+
+autoFormulaBlockProgram Formula_toBlockProgram () {
+	try {
+		if (theExpressionType [theLevel] != kFormula_EXPRESSION_TYPE_NUMERIC)
+			return autoFormulaBlockProgram();
+		const Daata source = theSource;
+		const integer n = numberOfInstructions;
+		if (n < 1)
+			return autoFormulaBlockProgram();
+		/*
+			Check that all instructions are allowed, and that the stack depth before each instruction
+			is the same along every path that leads to it. Jumps go forward only.
+		*/
+		autoINTVEC stackDepths = raw_INTVEC (n + 1);
+		for (integer i = 1; i <= n + 1; i ++)
+			stackDepths [i] = -1;
+		stackDepths [1] = 0;
+		autoINTVEC jumps = zero_INTVEC (n);
+		integer maximumStackDepth = 0;
+		bool hasJumps = false;
+		auto arrive = [&] (integer instruction, integer depth) -> bool {
+			if (stackDepths [instruction] == -1)
+				stackDepths [instruction] = depth;
+			return stackDepths [instruction] == depth;
+		};
+		for (integer i = 1; i <= n; i ++) {
+			const integer depth = stackDepths [i];
+			if (depth == -1)
+				continue;   // unreachable
+			const integer symbol = parse [i]. symbol;
+			const integer effect = blockStackEffect (symbol);
+			if (effect == kBlockStackEffect_NOT_ALLOWED)
+				return autoFormulaBlockProgram();
+			if (symbol == SELF0_) {
+				if (! source || source -> v_hasGetCell () || ! (source -> v_hasGetVector () || source -> v_hasGetMatrix ()))
+					return autoFormulaBlockProgram();   // Formula_run () will complain
+			} else if (symbol == X_) {
+				if (! source || ! source -> v_hasGetX ())
+					return autoFormulaBlockProgram();
+			} else if (symbol == Y_) {
+				if (! source || ! source -> v_hasGetY ())
+					return autoFormulaBlockProgram();
+			}
+			const integer newDepth = depth + effect;
+			if (newDepth < 0)
+				return autoFormulaBlockProgram();
+			Melder_clipLeft (newDepth, & maximumStackDepth);
+			if (symbol == GOTO_ || symbol == IFTRUE_ || symbol == IFFALSE_) {
+				hasJumps = true;
+				jumps [i] = parse [i]. content.label + 1 - theOptimize;   // see Formula_run ()
+				if (jumps [i] <= i || jumps [i] > n + 1 || ! arrive (jumps [i], newDepth))
+					return autoFormulaBlockProgram();
+				if (symbol == GOTO_)
+					continue;   // no fall-through
+			}
+			if (! arrive (i + 1, newDepth))
+				return autoFormulaBlockProgram();
+		}
+		if (stackDepths [n + 1] != 1)
+			return autoFormulaBlockProgram();
+
+		autoFormulaBlockProgram me = Thing_new (FormulaBlockProgram);
+		my numberOfInstructions = n;
+		my maximumStackDepth = maximumStackDepth;
+		my symbols = raw_INTVEC (n);
+		my numbers = zero_VEC (n);
+		for (integer i = 1; i <= n; i ++) {
+			my symbols [i] = parse [i]. symbol;
+			if (my symbols [i] == NUMBER_)
+				my numbers [i] = definedOrUndefined (parse [i]. content.number);
+			else if (my symbols [i] == NUMERIC_VARIABLE_)
+				my numbers [i] = definedOrUndefined (parse [i]. content.variable -> numericValue);   // the formula cannot change it
+		}
+		my jumps = jumps.move();
+		my stackDepths = stackDepths.move();
+		my hasJumps = hasJumps;
+		my source = source;
+		return me;
+	} catch (MelderError) {
+		Melder_throw (U"Formula: block program not created.");
+	}
+}
+
+void FormulaBlockProgram_run (const FormulaBlockProgram me, const integer row, const integer fromColumn, VEC const& result) {
+	constexpr integer blockSize = 256;
+	autoMAT stack = raw_MAT (std::max (my maximumStackDepth, 1_integer), blockSize);
+	autoINTVEC nextInstruction = raw_INTVEC (blockSize);   // per lane, if there are jumps
+	autoINTVEC activeLanes = raw_INTVEC (blockSize);
+	for (integer firstElement = 1; firstElement <= result.size; firstElement += blockSize) {
+		const integer numberOfLanes = std::min (blockSize, result.size - firstElement + 1);
+		const integer firstColumn = fromColumn + firstElement - 1;
+		if (my hasJumps)
+			for (integer lane = 1; lane <= numberOfLanes; lane ++)
+				nextInstruction [lane] = 1;
+		for (integer instruction = 1; instruction <= my numberOfInstructions; instruction ++) {
+			const integer depth = my stackDepths [instruction];
+			if (depth == -1)
+				continue;
+			integer numberOfActiveLanes = numberOfLanes;
+			if (my hasJumps) {
+				numberOfActiveLanes = 0;
+				for (integer lane = 1; lane <= numberOfLanes; lane ++)
+					if (nextInstruction [lane] == instruction)
+						activeLanes [++ numberOfActiveLanes] = lane;
+				if (numberOfActiveLanes == 0)
+					continue;
+			}
+			const bool allLanesAreActive = ( numberOfActiveLanes == numberOfLanes );
+			auto forActiveLanes = [&] (auto const& operation) {
+				if (allLanesAreActive)
+					for (integer lane = 1; lane <= numberOfLanes; lane ++)
+						operation (lane);
+				else
+					for (integer ilane = 1; ilane <= numberOfActiveLanes; ilane ++)
+						operation (activeLanes [ilane]);
+			};
+			auto stackRow = [&] (integer level) -> double * {
+				return ( level >= 1 && level <= my maximumStackDepth ? stack [level]. asArgumentToFunctionThatExpectsOneBasedArray () : nullptr );
+			};
+			double * const x = stackRow (depth - 1);   // the second-highest element
+			double * const y = stackRow (depth);   // the top of the stack
+			double * const push = stackRow (depth + 1);
+			const integer symbol = my symbols [instruction];
+			switch (symbol) {
+				case NUMBER_: case NUMERIC_VARIABLE_: {
+					const double value = my numbers [instruction];
+					forActiveLanes ([&] (integer lane) { push [lane] = value; });
+				} break; case TRUE_: {
+					forActiveLanes ([&] (integer lane) { push [lane] = 1.0; });
+				} break; case FALSE_: {
+					forActiveLanes ([&] (integer lane) { push [lane] = 0.0; });
+				} break; case ROW_: {
+					forActiveLanes ([&] (integer lane) { push [lane] = row; });
+				} break; case COL_: {
+					forActiveLanes ([&] (integer lane) { push [lane] = firstColumn + lane - 1; });
+				} break; case X_: {
+					forActiveLanes ([&] (integer lane) { push [lane] = definedOrUndefined (my source -> v_getX (firstColumn + lane - 1)); });
+				} break; case Y_: {
+					const double value = definedOrUndefined (my source -> v_getY (row));
+					forActiveLanes ([&] (integer lane) { push [lane] = value; });
+				} break; case SELF0_: {
+					if (my source -> v_hasGetVector ())
+						forActiveLanes ([&] (integer lane) { push [lane] = definedOrUndefined (my source -> v_getVector (row, firstColumn + lane - 1)); });
+					else
+						forActiveLanes ([&] (integer lane) { push [lane] = definedOrUndefined (my source -> v_getMatrix (row, firstColumn + lane - 1)); });
+				} break; case ADD_: {
+					forActiveLanes ([&] (integer lane) { x [lane] += y [lane]; });
+				} break; case SUB_: {
+					forActiveLanes ([&] (integer lane) { x [lane] -= y [lane]; });
+				} break; case MUL_: {
+					forActiveLanes ([&] (integer lane) { x [lane] *= y [lane]; });
+				} break; case RDIV_: {
+					forActiveLanes ([&] (integer lane) { x [lane] = definedOrUndefined (x [lane] / y [lane]); });
+				} break; case IDIV_: {
+					forActiveLanes ([&] (integer lane) { x [lane] = definedOrUndefined (floor (x [lane] / y [lane])); });
+				} break; case MOD_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = definedOrUndefined (x [lane] - floor (x [lane] / y [lane]) * y [lane]);
+					});
+				} break; case POWER_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = ( isundef (x [lane]) || isundef (y [lane]) ? undefined : definedOrUndefined (pow (x [lane], y [lane])) );
+					});
+				} break; case EQ_: {
+					forActiveLanes ([&] (integer lane) { x [lane] = ( NUMequal (x [lane], y [lane]) ? 1.0 : 0.0 ); });
+				} break; case NE_: {
+					forActiveLanes ([&] (integer lane) { x [lane] = ( NUMequal (x [lane], y [lane]) ? 0.0 : 1.0 ); });
+				} break; case LE_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = ( isdefined (x [lane]) ? isdefined (y [lane]) && x [lane] <= y [lane] : isundef (y [lane]) ) ? 1.0 : 0.0;
+					});
+				} break; case LT_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = ( isdefined (x [lane]) && isdefined (y [lane]) && x [lane] < y [lane] ? 1.0 : 0.0 );
+					});
+				} break; case GE_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = ( isdefined (x [lane]) ? isdefined (y [lane]) && x [lane] >= y [lane] : isundef (y [lane]) ) ? 1.0 : 0.0;
+					});
+				} break; case GT_: {
+					forActiveLanes ([&] (integer lane) {
+						x [lane] = ( isdefined (x [lane]) && isdefined (y [lane]) && x [lane] > y [lane] ? 1.0 : 0.0 );
+					});
+				} break; case NOT_: {
+					forActiveLanes ([&] (integer lane) { y [lane] = ( isundef (y [lane]) ? undefined : y [lane] == 0.0 ? 1.0 : 0.0 ); });
+				} break; case MINUS_: {
+					forActiveLanes ([&] (integer lane) { y [lane] = definedOrUndefined (- y [lane]); });
+				} break; case SQR_: {
+					forActiveLanes ([&] (integer lane) { y [lane] = ( isundef (y [lane]) ? undefined : definedOrUndefined (y [lane] * y [lane]) ); });
+				} break; case IFTRUE_: case IFFALSE_: {
+					const bool jumpIfTrue = ( symbol == IFTRUE_ );
+					const integer target = my jumps [instruction];
+					forActiveLanes ([&] (integer lane) {
+						nextInstruction [lane] = ( (y [lane] != 0.0) == jumpIfTrue ? target : instruction + 1 );
+					});
+					continue;
+				} break; case GOTO_: {
+					const integer target = my jumps [instruction];
+					forActiveLanes ([&] (integer lane) { nextInstruction [lane] = target; });
+					continue;
+				} break; case LABEL_: {
+					;
+				} break; default: {
+					double (*const uncheckedFunction) (double) = blockFunction1Unchecked (symbol);
+					double (*const checkedFunction) (double) = blockFunction1Checked (symbol);
+					double (*const function2) (double, double) = blockFunction2 (symbol);
+					if (uncheckedFunction) {
+						forActiveLanes ([&] (integer lane) { y [lane] = definedOrUndefined (uncheckedFunction (y [lane])); });
+					} else if (checkedFunction) {
+						forActiveLanes ([&] (integer lane) { y [lane] = ( isundef (y [lane]) ? undefined : definedOrUndefined (checkedFunction (y [lane])) ); });
+					} else if (function2) {
+						forActiveLanes ([&] (integer lane) {
+							x [lane] = ( isundef (x [lane]) || isundef (y [lane]) ? undefined : definedOrUndefined (function2 (x [lane], y [lane])) );
+						});
+					} else {
+						Melder_fatal (U"FormulaBlockProgram_run: unexpected symbol ", Formula_instructionNames [symbol], U".");
+					}
+				}
+			}
+			if (my hasJumps)
+				forActiveLanes ([&] (integer lane) { nextInstruction [lane] = instruction + 1; });
+		}
+		for (integer lane = 1; lane <= numberOfLanes; lane ++)
+			result [firstElement + lane - 1] = stack [1] [lane];
+	}
+}
+
+bool Formula_canRunInParallel () {
+	if (theLevel != 1)
+		return false;   // we are inside a formula that is being run
+	for (integer i = 1; i <= numberOfInstructions; i ++) {
+		const integer symbol = parse [i]. symbol;
+		if (symbol >= LOW_ATTRIBUTE && symbol <= HIGH_ATTRIBUTE)
+			continue;   // including row, col, x, y
+		switch (symbol) {
+			case NUMBER_: case TRUE_: case FALSE_: case STRING_:
+			case NUMERIC_VARIABLE_: case STRING_VARIABLE_:
+			case SELF0_: case SELFSTR0_: case SELFMATRIX1_: case SELFMATRIX1_STR_:   // the current cell, or a cell in the current row
+			case NOT_: case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+			case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case POWER_: case MINUS_: case SQR_:
+			case GOTO_: case IFTRUE_: case IFFALSE_: case LABEL_:
+			case FISHER_P_: case FISHER_Q_: case INV_FISHER_Q_:
+			case BINOMIAL_P_: case BINOMIAL_Q_: case INCOMPLETE_BETA_: case INV_BINOMIAL_P_: case INV_BINOMIAL_Q_:
+			case MIN_: case MAX_: case IMIN_: case IMAX_:
+			case LENGTH_: case STRING_TO_NUMBER_: case STRING_STR_: case FIXED_STR_: case PERCENT_STR_:
+			case LEFT_STR_: case RIGHT_STR_: case MID_STR_: case INDEX_: case RINDEX_: case STARTS_WITH_: case ENDS_WITH_:
+				continue;
+			default:
+				if (blockStackEffect (symbol) != kBlockStackEffect_NOT_ALLOWED)
+					continue;   // the deterministic functions of one or two numbers
+				return false;   // random numbers, objects, files, info, nested formulas, loops, self [row, col] ...
+		}
+	}
+	return true;
+}
+
 /* End of file Formula.cpp */
@@ -189,7 +189,64 @@ Thing_declare (Interpreter);
 
 void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
 
+void Formula_compileWithCache (Interpreter interpreter, conststring32 expression, int expressionType);
+/*
+	Does the same as Formula_compile (interpreter, nullptr, expression, expressionType, false),
+	but reuses the compiled instructions if the (non-null) interpreter has compiled the same expression before,
+	so that a script line that is executed many times is lexed and parsed only once.
+*/
+
+void Formula_forgetCompiledExpressions (Interpreter interpreter) noexcept;
+/*
+	To be called whenever the interpreter throws its variables away.
+*/
+
+struct Formula_CacheStatistics {
+	integer numberOfHits, numberOfMisses, numberOfUncacheableExpressions, numberOfCachedExpressions;
+};
+Formula_CacheStatistics Formula_getCacheStatistics ();
+
 void Formula_run (integer row, integer col, Formula_Result *result);
 
+bool Formula_canRunInParallel ();
+/*
+	To be called directly after Formula_compile ().
+	Returns true if the formula reads nothing but the current cell, other cells in the current row,
+	numbers, strings and variables, and calls nothing but functions that do not change anything;
+	Formula_run () can then be called from several threads at the same time, for different rows.
+	Each thread will have its own stack.
+*/
+
+/*
+	A numeric formula that refers to nothing but `self`, `row`, `col`, `x`, `y`,
+	numbers, numeric variables, arithmetic, comparisons, `if`, `and`, `or`, and the deterministic
+	functions of one or two numbers, can be run for a whole stretch of columns at a time,
+	so that the instructions are dispatched once per block of cells rather than once per cell.
+	Such a "block program" is a frozen copy of the formula, and can be run from several threads at once,
+	as long as nobody changes the object in the meantime.
+*/
+Thing_define (FormulaBlockProgram, Thing) {
+	integer numberOfInstructions, maximumStackDepth;
+	autoINTVEC symbols;
+	autoVEC numbers;   // for constants and variables
+	autoINTVEC jumps;   // the next instruction, for GOTO_, IFTRUE_ and IFFALSE_
+	autoINTVEC stackDepths;   // before each instruction; -1 if the instruction cannot be reached
+	bool hasJumps;
+	Daata source;
+};
+
+autoFormulaBlockProgram Formula_toBlockProgram ();
+/*
+	To be called directly after Formula_compile (), with kFormula_EXPRESSION_TYPE_NUMERIC.
+	Returns an empty autoFormulaBlockProgram if the formula is not of the above kind,
+	in which case the caller should use Formula_run ().
+*/
+
+void FormulaBlockProgram_run (FormulaBlockProgram me, integer row, integer fromColumn, VEC const& result);
+/*
+	Gives the same results as calling Formula_run (row, icol, ...) for icol = fromColumn .. fromColumn + result.size - 1,
+	and then storing result.numericResult.
+*/
+
 /* End of file Formula.h */
 #endif
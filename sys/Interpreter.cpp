@@ -106,6 +106,7 @@ static CollectionOf <structInterpreter> theReferencesToAllLivingInterpreters;
 
 void structInterpreter :: v9_destroy () noexcept {
 	theReferencesToAllLivingInterpreters. undangleItem (this);
+	Formula_forgetCompiledExpressions (this);
 	our Interpreter_Parent :: v9_destroy ();
 }
 
@@ -2112,6 +2113,7 @@ void Interpreter_run (Interpreter me, char32 *text, const bool reuseVariables) {
 			Copy the parameter names and argument values into the array of variables.
 		*/
 		if (! reuseVariables) {
+			Formula_forgetCompiledExpressions (me);
 			my variablesMap. clear ();
 			for (ipar = 1; ipar <= my numberOfParameters; ipar ++) {
 				char32 parameter [1+Interpreter_MAX_PARAMETER_LENGTH];
@@ -3477,20 +3479,20 @@ void Interpreter_stop (Interpreter me) {
 }
 
 void Interpreter_voidExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 }
 
 void Interpreter_numericExpression (Interpreter me, conststring32 expression, double *out_value) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 	*out_value = result. numericResult;
 }
 
 void Interpreter_numericVectorExpression (Interpreter me, conststring32 expression, VEC *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 	*out_value = result. numericVectorResult;
@@ -3499,7 +3501,7 @@ void Interpreter_numericVectorExpression (Interpreter me, conststring32 expressi
 }
 
 void Interpreter_numericMatrixExpression (Interpreter me, conststring32 expression, MAT *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 	*out_value = result. numericMatrixResult;
@@ -3508,14 +3510,14 @@ void Interpreter_numericMatrixExpression (Interpreter me, conststring32 expressi
 }
 
 autostring32 Interpreter_stringExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_STRING, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_STRING);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 	return result. stringResult.move();
 }
 
 void Interpreter_stringArrayExpression (Interpreter me, conststring32 expression, STRVEC *out_value, bool *out_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_STRING_ARRAY, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_STRING_ARRAY);
 	Formula_Result result;
 	Formula_run (0, 0, & result);
 	*out_value = result. stringArrayResult;
@@ -3524,7 +3526,7 @@ void Interpreter_stringArrayExpression (Interpreter me, conststring32 expression
 }
 
 void Interpreter_anyExpression (Interpreter me, conststring32 expression, Formula_Result *out_result) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, false);
+	Formula_compileWithCache (me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN);
 	Formula_run (0, 0, out_result);
 }
 
@@ -923,6 +923,10 @@ void ManPages_addPage (ManPages me, conststring32 title, conststring32 signature
 	my pages. addItem_move (page.move());
 }
 void ManPages_addPagesFromNotebookText (ManPages me, conststring8 multiplePagesText) {
+	* my unparsedNotebookTexts. append () = multiplePagesText;
+	my ground = false;
+}
+static void parseNotebookText (ManPages me, conststring8 multiplePagesText) {
 	autoMelderReadText multiplePagesReader = MelderReadText_createFromText (Melder_8to32 (multiplePagesText));
 	autoMelderString pageText;
 	for (;;) {
@@ -1030,7 +1034,17 @@ static integer lookUp_sorted (ManPages me, conststring32 title) {
 	return 0;
 }
 
-static void grind (ManPages me) {
+static void parseUnparsedNotebookTexts (ManPages me) {
+	/*
+		In the order in which they were added, so that of two notebook pages with the same title, the first one wins.
+	*/
+	for (integer itext = 1; itext <= my unparsedNotebookTexts.size; itext ++)
+		parseNotebookText (me, my unparsedNotebookTexts [itext]);
+	my unparsedNotebookTexts. resize (0);
+}
+
+void ManPages_grind (ManPages me) {
+	parseUnparsedNotebookTexts (me);
 	std::sort (my pages.begin(), my pages.end(), pageCompare);
 	for (integer ipage = 1; ipage <= my pages.size; ipage ++) {
 		ManPage page = my pages.at [ipage];
@@ -1097,7 +1111,7 @@ integer ManPages_uniqueLinksHither (ManPages me, integer ipage) {
 integer ManPages_lookUp (ManPages me, conststring32 title) {
 	if (! my ground) {
 		//Melder_stopwatch ();
-		grind (me);
+		ManPages_grind (me);
 		//Melder_information (U"grinding lasted ", Melder_stopwatch (), U" seconds.");
 	}
 	return lookUp_sorted (me, title);
@@ -1105,7 +1119,7 @@ integer ManPages_lookUp (ManPages me, conststring32 title) {
 
 integer ManPages_lookUp_caseSensitive (ManPages me, conststring32 title) {
 	if (! my ground)
-		grind (me);
+		ManPages_grind (me);
 	for (integer i = 1; i <= my pages.size; i ++) {
 		ManPage page = my pages.at [i];
 		if (str32equ (page -> title.get(), title))
@@ -1116,7 +1130,7 @@ integer ManPages_lookUp_caseSensitive (ManPages me, conststring32 title) {
 
 constSTRVEC ManPages_getTitles (ManPages me) {
 	if (! my ground)
-		grind (me);
+		ManPages_grind (me);
 	if (! my titles) {
 		my titles = autoSTRVEC (my pages.size);
 		for (integer i = 1; i <= my pages.size; i ++) {
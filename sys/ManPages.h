@@ -30,6 +30,7 @@ Thing_define (ManPages, Daata) {
 
 	autoSTRVEC titles;
 	bool ground, dynamic, executable, commandsWithExternalSideEffectsAreAllowed = true;
+	autovector <conststring8> unparsedNotebookTexts;   // statically allocated; parsed into pages when the pages are ground
 	structMelderFolder rootDirectory;
 
 	void v9_destroy () noexcept
@@ -50,8 +51,18 @@ void ManPages_addPage (ManPages me, conststring32 title, conststring32 copyright
 */
 
 void ManPages_addPagesFromNotebookText (ManPages me, conststring8 text);
+/*
+	The text must be statically allocated.
+	It is not parsed until the first lookup (or title list or HTML export),
+	so that programs that never show the manual do not pay for the parsing at start-up.
+*/
 integer ManPages_addPagesFromNotebookReader (ManPages me, MelderReadText multiplePagesReader, integer startOfSelection, integer endOfSelection);
 
+void ManPages_grind (ManPages me);
+/*
+	Parse any unparsed notebook texts, sort the pages by title, and compute the links between the pages.
+	The lookup functions and ManPages_getTitles () do this automatically the first time.
+*/
 integer ManPages_lookUp (ManPages me, conststring32 title);
 integer ManPages_lookUp_caseSensitive (ManPages me, conststring32 title);
 
@@ -790,6 +790,8 @@ void ManPages_writeOneToHtmlFile (ManPages me, Interpreter optionalInterpreterRe
 }
 
 void ManPages_writeAllToHtmlDir (ManPages me, Interpreter optionalInterpreterReference, conststring32 dirPath) {
+	if (! my ground)
+		ManPages_grind (me);
 	structMelderFolder dir { };
 	Melder_pathToFolder (dirPath, & dir);
 	for (integer ipage = 1; ipage <= my pages.size; ipage ++) {
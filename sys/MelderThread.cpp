@@ -0,0 +1,242 @@
+/* MelderThread.cpp
+ *
+ * Copyright (C) 2026 agent
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MelderThread.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+
+static std::atomic <bool> theUseMultithreading (true);
+static std::atomic <integer> theMaximumNumberOfThreads (0);   // 0 = automatic
+
+void MelderThread_setUseMultithreading (bool useMultithreading) {
+	theUseMultithreading = useMultithreading;
+}
+
+bool MelderThread_getUseMultithreading () {
+	return theUseMultithreading;
+}
+
+void MelderThread_setMaximumNumberOfThreads (integer maximumNumberOfThreads) {
+	theMaximumNumberOfThreads = std::max (0_integer, maximumNumberOfThreads);
+}
+
+integer MelderThread_getMaximumNumberOfThreads () {
+	const integer maximumNumberOfThreads = theMaximumNumberOfThreads;
+	if (maximumNumberOfThreads > 0)
+		return maximumNumberOfThreads;
+	return std::max (1_integer, MelderThread_getNumberOfProcessors ());
+}
+
+integer MelderThread_getMaximumNumberOfThreadsSetting () {
+	return theMaximumNumberOfThreads;
+}
+
+integer MelderThread_computeNumberOfThreads (integer numberOfElements, integer minimumNumberOfElementsPerThread) {
+	if (! theUseMultithreading || numberOfElements < 2)
+		return 1;
+	Melder_clipLeft (1_integer, & minimumNumberOfElementsPerThread);
+	integer numberOfThreads = 1 + (numberOfElements - 1) / minimumNumberOfElementsPerThread;
+	Melder_clip (1_integer, & numberOfThreads, MelderThread_getMaximumNumberOfThreads ());
+	return numberOfThreads;
+}
+
+/*
+	A job is a single call to MelderThread_runChunked.
+	Thread number `ithread` initially owns the chunks from nextChunk [ithread] to lastChunk [ithread];
+	`nextChunk [ithread]` is only ever incremented (by the owner or by thieves),
+	so that each chunk is handed out exactly once without any locking.
+*/
+struct MelderThread_Job {
+	std::function <void (integer, integer, integer)> const *analyseElements;
+	integer numberOfThreads, numberOfElements, chunkSize;
+	std::unique_ptr <std::atomic <integer> []> nextChunk;
+	std::unique_ptr <integer []> lastChunk;
+	std::atomic <bool> cancelled { false };
+	std::mutex exceptionMutex;
+	std::exception_ptr exception;
+	/*
+		Guarded by the pool's mutex.
+	*/
+	integer numberOfClaimedThreads = 1;   // the calling thread is number 1
+	integer numberOfActiveHelpers = 0;
+
+	integer claimChunk (integer ithread) {
+		for (integer ioffset = 0; ioffset < numberOfThreads; ioffset ++) {
+			const integer victim = 1 + (ithread - 1 + ioffset) % numberOfThreads;
+			const integer ichunk = nextChunk [victim] ++;
+			if (ichunk <= lastChunk [victim])
+				return ichunk;
+		}
+		return 0;   // nothing left anywhere
+	}
+
+	void work (integer ithread) {
+		integer ichunk;
+		while (! cancelled && (ichunk = claimChunk (ithread)) != 0) {
+			const integer fromElement = (ichunk - 1) * chunkSize + 1;
+			const integer toElement = std::min (fromElement + chunkSize - 1, numberOfElements);
+			try {
+				(*analyseElements) (ithread, fromElement, toElement);
+			} catch (...) {
+				std::lock_guard <std::mutex> lock (exceptionMutex);
+				if (! exception)
+					exception = std::current_exception ();
+				cancelled = true;
+			}
+		}
+	}
+};
+
+static thread_local bool theCurrentThreadIsAWorker = false;
+
+static struct MelderThread_Pool {
+	std::mutex mutex;
+	std::condition_variable workAvailable, helpersDone;
+	std::vector <std::thread> workers;
+	MelderThread_Job *currentJob = nullptr;
+	integer numberOfHelpersWanted = 0;
+	bool shuttingDown = false;
+
+	void workerLoop () {
+		theCurrentThreadIsAWorker = true;
+		std::unique_lock <std::mutex> lock (mutex);
+		for (;;) {
+			workAvailable. wait (lock, [this] { return shuttingDown || (currentJob && numberOfHelpersWanted > 0); });
+			if (shuttingDown)
+				return;
+			MelderThread_Job *job = currentJob;
+			numberOfHelpersWanted --;
+			job -> numberOfActiveHelpers ++;
+			const integer ithread = ++ job -> numberOfClaimedThreads;
+			lock. unlock ();
+			job -> work (ithread);
+			lock. lock ();
+			if (-- job -> numberOfActiveHelpers == 0)
+				helpersDone. notify_all ();
+		}
+	}
+
+	/*
+		To be called with the mutex locked.
+	*/
+	void ensureNumberOfWorkers (integer numberOfWorkers) {
+		while (integer (workers.size ()) < numberOfWorkers)
+			workers. emplace_back (& MelderThread_Pool::workerLoop, this);
+	}
+
+	~ MelderThread_Pool () {
+		{
+			std::lock_guard <std::mutex> lock (mutex);
+			shuttingDown = true;
+		}
+		workAvailable. notify_all ();
+		for (std::thread& worker : workers)
+			if (worker. joinable ())
+				worker. join ();
+	}
+} thePool;
+
+void MelderThread_runChunked (integer numberOfThreads, integer numberOfElements, integer chunkSize,
+	std::function <void (integer ithread, integer fromElement, integer toElement)> const& analyseElements)
+{
+	if (numberOfElements < 1)
+		return;
+	Melder_clip (1_integer, & numberOfThreads, numberOfElements);
+	if (numberOfThreads == 1 || theCurrentThreadIsAWorker) {
+		analyseElements (1, 1, numberOfElements);
+		return;
+	}
+	if (chunkSize <= 0)
+		chunkSize = std::max (1_integer, numberOfElements / (8 * numberOfThreads));   // enough chunks for stealing
+	const integer numberOfChunks = 1 + (numberOfElements - 1) / chunkSize;
+	Melder_clipRight (& numberOfThreads, numberOfChunks);
+
+	MelderThread_Job job;
+	job.analyseElements = & analyseElements;
+	job.numberOfThreads = numberOfThreads;
+	job.numberOfElements = numberOfElements;
+	job.chunkSize = chunkSize;
+	job.nextChunk = std::make_unique <std::atomic <integer> []> (uinteger (numberOfThreads + 1));
+	job.lastChunk = std::make_unique <integer []> (uinteger (numberOfThreads + 1));
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		job.nextChunk [ithread] = 1 + (ithread - 1) * numberOfChunks / numberOfThreads;
+		job.lastChunk [ithread] = ithread * numberOfChunks / numberOfThreads;
+	}
+
+	bool poolIsOurs = false;
+	{
+		std::lock_guard <std::mutex> lock (thePool.mutex);
+		if (! thePool.currentJob) {   // otherwise, another thread is using the pool, and we do everything ourselves
+			try {
+				thePool. ensureNumberOfWorkers (numberOfThreads - 1);
+			} catch (...) {
+				// if the system refuses to give us more threads, we continue with the workers we have
+			}
+			thePool.currentJob = & job;
+			thePool.numberOfHelpersWanted = numberOfThreads - 1;
+			poolIsOurs = true;
+		}
+	}
+	if (poolIsOurs)
+		thePool.workAvailable. notify_all ();
+
+	job. work (1);
+
+	if (poolIsOurs) {
+		std::unique_lock <std::mutex> lock (thePool.mutex);
+		thePool.currentJob = nullptr;
+		thePool.numberOfHelpersWanted = 0;
+		thePool.helpersDone. wait (lock, [&job] { return job.numberOfActiveHelpers == 0; });
+	}
+	if (job.exception)
+		std::rethrow_exception (job.exception);
+}
+
+integer MelderThread_computeNumberOfStretches (integer numberOfElements, integer blockSize, integer maximumNumberOfStretches) {
+	if (numberOfElements < 1)
+		return 0;
+	const integer numberOfBlocks = (numberOfElements - 1) / blockSize + 1;
+	return std::min (numberOfBlocks, maximumNumberOfStretches);
+}
+
+void MelderThread_runInStretches (integer numberOfThreads, integer numberOfElements, integer blockSize, integer maximumNumberOfStretches,
+	std::function <void (integer ithread, integer istretch, integer fromElement, integer toElement)> const& analyseBlock)
+{
+	const integer numberOfStretches = MelderThread_computeNumberOfStretches (numberOfElements, blockSize, maximumNumberOfStretches);
+	if (numberOfStretches == 0)
+		return;
+	const integer numberOfBlocks = (numberOfElements - 1) / blockSize + 1;
+	MelderThread_runChunked (numberOfThreads, numberOfStretches, 1,
+		[&] (integer ithread, integer fromStretch, integer toStretch) {
+			for (integer istretch = fromStretch; istretch <= toStretch; istretch ++) {
+				const integer fromBlock = (istretch - 1) * numberOfBlocks / numberOfStretches + 1;
+				const integer toBlock = istretch * numberOfBlocks / numberOfStretches;
+				for (integer iblock = fromBlock; iblock <= toBlock; iblock ++) {
+					const integer fromElement = (iblock - 1) * blockSize + 1;
+					const integer toElement = std::min (iblock * blockSize, numberOfElements);
+					analyseBlock (ithread, istretch, fromElement, toElement);
+				}
+			}
+		}
+	);
+}
+
+/* End of file MelderThread.cpp */
@@ -19,6 +19,7 @@
  */
 
 #include <vector>
+#include <functional>
 #include "Thing.h"
 #include <thread>
 
@@ -26,25 +27,69 @@ inline integer MelderThread_getNumberOfProcessors () {
 	return uinteger_to_integer (std::thread::hardware_concurrency ());
 }
 
+/*
+	All multi-threaded analyses run on a single process-wide pool of worker threads.
+	The pool is created lazily, the first time that an analysis asks for more than one thread,
+	and the worker threads then sleep between analyses instead of being created and joined anew
+	for every call; this matters if you analyse thousands of short sounds in a script.
+*/
+void MelderThread_setUseMultithreading (bool useMultithreading);
+bool MelderThread_getUseMultithreading ();
+
+void MelderThread_setMaximumNumberOfThreads (integer maximumNumberOfThreads);   // 0 = automatic
+integer MelderThread_getMaximumNumberOfThreads ();   // resolved: the setting, or the number of processors if the setting is 0
+integer MelderThread_getMaximumNumberOfThreadsSetting ();   // 0 = automatic
+/*
+	Returns the number set by the user, or else the number of processors; always at least 1.
+*/
+
+integer MelderThread_computeNumberOfThreads (integer numberOfElements, integer minimumNumberOfElementsPerThread);
+/*
+	Returns 1 if multithreading is switched off.
+*/
+
+void MelderThread_runChunked (integer numberOfThreads, integer numberOfElements, integer chunkSize,
+	std::function <void (integer ithread, integer fromElement, integer toElement)> const& analyseElements);
+/*
+	Calls analyseElements for consecutive chunks of `chunkSize` elements (0 = automatic),
+	until each of the elements 1 .. numberOfElements has been handed out exactly once.
+	`ithread` runs from 1 to numberOfThreads and identifies the workspace that the caller may use:
+	no two threads ever work with the same `ithread` at the same time.
+	Every thread first works through its own contiguous share of the chunks,
+	then steals the remaining chunks of the threads that are slower (or that never started).
+	The calling thread always takes part, as thread number 1, so that only the function call
+	with ithread == 1 is allowed to call Melder_progress () and the like.
+	If any call of analyseElements throws, no new chunks are handed out,
+	and the exception is rethrown in the calling thread after all threads have finished.
+	Called from within a worker thread, the function runs all elements in the calling thread.
+*/
+
+integer MelderThread_computeNumberOfStretches (integer numberOfElements, integer blockSize, integer maximumNumberOfStretches);
+/*
+	Returns the number of stretches that MelderThread_runInStretches () will use:
+	one for each block of `blockSize` elements, but no more than `maximumNumberOfStretches`;
+	0 if there are no elements.
+*/
+
+void MelderThread_runInStretches (integer numberOfThreads, integer numberOfElements, integer blockSize, integer maximumNumberOfStretches,
+	std::function <void (integer ithread, integer istretch, integer fromElement, integer toElement)> const& analyseBlock);
+/*
+	Calls analyseBlock for consecutive blocks of `blockSize` elements (the last block can be shorter).
+	The blocks are grouped into the stretches of consecutive blocks numbered 1 .. MelderThread_computeNumberOfStretches (),
+	and the stretches are handed out to the threads as in MelderThread_runChunked ().
+	The division into stretches does not depend on the number of threads,
+	and the blocks of a stretch are analysed in order by a single thread;
+	a caller that sums its results per stretch, and afterwards adds up the stretch sums in stretch order,
+	therefore gets a result that does not depend on the number of threads.
+*/
+
 template <class T> void MelderThread_run (void (*func) (T *), autoSomeThing <T> *args, integer numberOfThreads) {
-	uinteger unsignedNumberOfThreads = integer_to_uinteger (numberOfThreads);
-	if (unsignedNumberOfThreads == 1) {
-		func (args [0].get());
-	} else {
-		std::vector <std::thread> thread (unsignedNumberOfThreads);
-		try {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				thread [ithread - 1] = std::thread (func, args [ithread - 1].get());
-			func (args [unsignedNumberOfThreads - 1].get());
-		} catch (MelderError) {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				if (thread [ithread - 1]. joinable ())
-					thread [ithread - 1]. join ();
-			throw;
+	MelderThread_runChunked (numberOfThreads, numberOfThreads, 1,
+		[&] (integer /* ithread */, integer fromElement, integer toElement) {
+			for (integer ielement = fromElement; ielement <= toElement; ielement ++)
+				func (args [ielement - 1].get());
 		}
-		for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-			thread [ithread - 1]. join ();
-	}
+	);
 }
 
 /* End of file MelderThread.h */
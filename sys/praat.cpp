@@ -1405,8 +1405,17 @@ static bool tryToSwitchToRunningPraat (bool foundTheOpenOption, bool foundTheSen
 	return false;   // the default
 }
 
+static double theClockAtStartOfInit, theClockAtEndOfInit, theClockAtStartOfRun;
+
+void praat_includeManPages (void (*manual_xxx_init) (ManPages me)) {
+	const double clockAtStart = Melder_clock ();
+	manual_xxx_init (theCurrentPraatApplication -> manPages);
+	praatP.startUpTimes.manPages += Melder_clock () - clockAtStart;
+}
+
 void praat_init (conststring32 title, int argc, char **argv)
 {
+	theClockAtStartOfInit = Melder_clock ();
 	setThePraatLocale ();
 	Melder_init ();
 	const bool weWereStartedFromTheCommandLine = tryToAttachToTheCommandLine ();
@@ -1881,6 +1890,9 @@ void praat_init (conststring32 title, int argc, char **argv)
 	if (! praatP.dontUsePictureWindow)
 		praat_picture_init (! praatP.commandLineOptions.hidePicture);
 	trace (U"after picture window shows: locale is ", Melder_peek8to32 (setlocale (LC_ALL, nullptr)));
+
+	theClockAtEndOfInit = Melder_clock ();
+	praatP.startUpTimes.init = theClockAtEndOfInit - theClockAtStartOfInit;
 }
 
 static void executeStartUpFile (MelderFolder startUpDirectory, conststring32 fileNameHead, conststring32 fileNameTail) {
@@ -1942,6 +1954,12 @@ static void executeStartUpFile (MelderFolder startUpDirectory, conststring32 fil
 #endif
 
 void praat_run () {
+	/*
+		Between praat_init () and praat_run (), the libraries have installed their commands and manual pages.
+	*/
+	theClockAtStartOfRun = Melder_clock ();
+	praatP.startUpTimes.libraries = theClockAtStartOfRun - theClockAtEndOfInit - praatP.startUpTimes.manPages;
+
 	trace (U"adding menus, second round");
 	praat_addMenus2 ();
 	trace (U"locale is ", Melder_peek8to32 (setlocale (LC_ALL, nullptr)));
@@ -2288,6 +2306,7 @@ void praat_run () {
 		Melder_assert (n1 == 456789 && n2 == -12345);
 	}
 
+	praatP.startUpTimes.run = Melder_clock () - theClockAtStartOfRun;   // for batch; measured again below for the GUI
 	if (Melder_batch) {
 		if (thePraatStandAloneScriptText) {
 			try {
@@ -2402,6 +2421,7 @@ void praat_run () {
 		praat_sortMenuCommands ();
 		praat_sortActions ();
 
+		praatP.startUpTimes.run = Melder_clock () - theClockAtStartOfRun;
 		praatP.phase = praat_HANDLING_EVENTS;
 
 		if (praatP.userWantsToOpen) {
@@ -231,7 +231,8 @@ void praat_picture_close ();
 #define INCLUDE_LIBRARY(praat_xxx_init)  \
    { extern void praat_xxx_init (); praat_xxx_init (); }
 #define INCLUDE_MANPAGES(manual_xxx_init)  \
-   { extern void manual_xxx_init (ManPages me); manual_xxx_init (theCurrentPraatApplication -> manPages); }
+   { extern void manual_xxx_init (ManPages me); praat_includeManPages (manual_xxx_init); }
+void praat_includeManPages (void (*manual_xxx_init) (ManPages me));   // times the registration of the pages, for "Report start-up times"
 
 /* For text-only applications that do not want to see that irritating Picture window. */
 /* Works only if called before praat_init. */
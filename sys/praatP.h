@@ -154,11 +154,13 @@ void praat_statistics_prefs ();   // at init time
 void praat_statistics_prefsChanged ();   // after reading prefs file
 void praat_statistics_exit ();   // at exit time
 void praat_reportMemoryUse ();
+void praat_reportFormulaCache ();
 void praat_reportSystemProperties ();
 void praat_reportGraphicalProperties ();
 void praat_reportIntegerProperties ();
 void praat_reportTextProperties ();
 void praat_reportFontProperties ();
+void praat_reportStartUpTimes ();
 
 /* Communication with praat_objectMenus.cpp: */
 GuiMenu praat_objects_resolveMenu (conststring32 menu);
@@ -188,6 +190,9 @@ inline struct PraatP {
 	struct {
 		bool hidePicture;   // hide the Picture window at start-up
 	} commandLineOptions;
+	struct {
+		double init, libraries, manPages, run;   // in seconds; see praat_reportStartUpTimes ()
+	} startUpTimes;
 	bool fileNamesCameInByDropping, foundTheOpenSwitch, foundTheRunSwitch, foundTheSendSwitch, foundTheNewSwitch;
 	bool userWantsToOpen, userWantsToSend, userWantsExistingInstance, hasFinishedLaunching;
 	bool dontUsePictureWindow;   // see praat_dontUsePictureWindow ()
@@ -22,12 +22,47 @@
 #include "../kar/longchar.h"
 #include "machine.h"
 #include "GuiP.h"
+#include <unordered_map>
+#include <string_view>
 
 #define BUTTON_LEFT  -240
 #define BUTTON_RIGHT -5
 
 static OrderedOf <structPraat_Command> theActions;
 void praat_actions_exit_optimizeByLeaking () { theActions. _ownItems = false; }
+
+/*
+	Scripts look up actions by title, perhaps millions of times,
+	so we keep an index from each title to the actions with that title, in the order of theActions.
+	The keys point into the titles of the actions themselves.
+	Every change in the number or order of the actions makes the index obsolete;
+	it is rebuilt at the next lookup, so that adding thousands of actions at start-up costs nothing extra.
+*/
+static std::unordered_map <std::u32string_view, std::vector <Praat_Command>> theActionsByTitle;
+static bool theActionsByTitleAreUpToDate = false;
+
+static void invalidateActionsByTitle () {
+	theActionsByTitleAreUpToDate = false;
+}
+
+static Praat_Command lookUpExecutableAction (conststring32 title) {
+	if (! theActionsByTitleAreUpToDate) {
+		theActionsByTitle. clear ();
+		for (integer i = 1; i <= theActions.size; i ++) {
+			Praat_Command action = theActions.at [i];
+			if (action -> title)
+				theActionsByTitle [action -> title.get()]. push_back (action);
+		}
+		theActionsByTitleAreUpToDate = true;
+	}
+	const auto found = theActionsByTitle. find (title);
+	if (found == theActionsByTitle. end ())
+		return nullptr;
+	for (Praat_Command action : found -> second)
+		if (action -> executable)
+			return action;   // the first executable one in the order of theActions, as in the menus
+	return nullptr;
+}
 static GuiMenu praat_writeMenu;
 static GuiMenuItem praat_writeMenuSeparator;
 static GuiForm praat_form;
@@ -182,6 +217,7 @@ static void praat_addAction4__ (ClassInfo class1, integer n1, ClassInfo class2,
 			Insert new command.
 		*/
 		theActions. addItemAtPosition_move (action.move(), position);
+		invalidateActionsByTitle ();
 	} catch (MelderError) {
 		Melder_flushError ();
 	}
@@ -294,8 +330,10 @@ void praat_addActionScript (conststring32 className1, integer n1, conststring32
 		*/
 		{// scope
 			integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
-			if (found)
+			if (found) {
 				theActions. removeItem (found);
+				invalidateActionsByTitle ();
+			}
 		}
 
 		/*
@@ -345,6 +383,7 @@ void praat_addActionScript (conststring32 className1, integer n1, conststring32
 			Insert new command.
 		*/
 		theActions. addItemAtPosition_move (action.move(), position);
+		invalidateActionsByTitle ();
 		updateDynamicMenu ();
 	} catch (MelderError) {
 		Melder_throw (U"Praat: script action not added.");
@@ -364,6 +403,7 @@ void praat_removeAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, c
 			);
 		}
 		theActions. removeItem (found);
+		invalidateActionsByTitle ();
 	} catch (MelderError) {
 		Melder_throw (U"Praat: action not removed.");
 	}
@@ -501,6 +541,7 @@ void praat_sortActions () {
 			return my sortingTail < thy sortingTail;
 		}
 	);
+	invalidateActionsByTitle ();
 }
 
 static conststring32 numberString (integer number) {
@@ -792,14 +833,7 @@ void praat_saveToggledActions (MelderString *buffer) {
 }
 
 int praat_doAction (conststring32 title, conststring32 arguments, Interpreter interpreter) {
-	Praat_Command actionFound = nullptr;
-	for (integer i = 1; i <= theActions.size; i ++) {
-		Praat_Command action = theActions.at [i];
-		if (action -> executable && str32equ (action -> title.get(), title)) {
-			actionFound = action;
-			break;
-		}
-	}
+	Praat_Command actionFound = lookUpExecutableAction (title);
 	if (! actionFound)
 		return 0;
 	if (actionFound -> callback == DO_RunTheScriptFromAnyAddedMenuCommand) {
@@ -822,14 +856,7 @@ int praat_doAction (conststring32 title, conststring32 arguments, Interpreter in
 }
 
 int praat_doAction (conststring32 title, integer narg, Stackel args, Interpreter interpreter) {
-	Praat_Command actionFound = nullptr;
-	for (integer i = 1; i <= theActions.size; i ++) {
-		Praat_Command action = theActions.at [i];
-		if (action -> executable && str32equ (action -> title.get(), title)) {
-			actionFound = action;
-			break;
-		}
-	}
+	Praat_Command actionFound = lookUpExecutableAction (title);
 	if (! actionFound)
 		return 0;
 	if (actionFound -> callback == DO_RunTheScriptFromAnyAddedMenuCommand) {
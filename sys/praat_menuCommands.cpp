@@ -20,10 +20,42 @@
 #include "praat_script.h"
 #include "praat_version.h"
 #include "GuiP.h"
+#include <unordered_map>
+#include <string_view>
 
 static OrderedOf <structPraat_Command> theCommands;
 void praat_menuCommands_exit_optimizeByLeaking () { theCommands. _ownItems = false; }
 
+/*
+	As for the actions (see praat_actions.cpp), an index from each title to the commands with that title,
+	in the order of theCommands, rebuilt at the first lookup after a change in the number or order of the commands.
+*/
+static std::unordered_map <std::u32string_view, std::vector <Praat_Command>> theCommandsByTitle;
+static bool theCommandsByTitleAreUpToDate = false;
+
+static void invalidateCommandsByTitle () {
+	theCommandsByTitleAreUpToDate = false;
+}
+
+static Praat_Command lookUpExecutableObjectsOrPictureCommand (conststring32 title) {
+	if (! theCommandsByTitleAreUpToDate) {
+		theCommandsByTitle. clear ();
+		for (integer i = 1; i <= theCommands.size; i ++) {
+			Praat_Command command = theCommands.at [i];
+			if (command -> title)
+				theCommandsByTitle [command -> title.get()]. push_back (command);
+		}
+		theCommandsByTitleAreUpToDate = true;
+	}
+	const auto found = theCommandsByTitle. find (title);
+	if (found == theCommandsByTitle. end ())
+		return nullptr;
+	for (Praat_Command command : found -> second)
+		if (command -> executable && (str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")))
+			return command;
+	return nullptr;
+}
+
 void praat_sortMenuCommands () {
 	for (integer i = 1; i <= theCommands.size; i ++) {
 		Praat_Command command = theCommands.at [i];
@@ -50,6 +82,7 @@ void praat_sortMenuCommands () {
 			return my sortingTail < thy sortingTail;
 		}
 	);
+	invalidateCommandsByTitle ();
 }
 
 static integer lookUpMatchingMenuCommand_0 (conststring32 window, conststring32 menu, conststring32 title) {
@@ -231,6 +264,7 @@ static GuiMenuItem praat_addMenuCommand__ (conststring32 window, conststring32 m
 	}
 	Thing_cast (GuiMenuItem, button_as_GuiMenuItem, command -> button);
 	theCommands. addItemAtPosition_move (command.move(), position);
+	invalidateCommandsByTitle ();
 	return button_as_GuiMenuItem;
 }
 GuiMenuItem praat_addMenuCommand_ (conststring32 window, conststring32 menu, conststring32 title /* cattable */,
@@ -351,6 +385,7 @@ void praat_addMenuCommandScript (conststring32 window, conststring32 menu, const
 			}
 		}
 		theCommands. addItemAtPosition_move (command.move(), position);
+		invalidateCommandsByTitle ();
 
 		if (praatP.phase >= praat_HANDLING_EVENTS)
 			praat_sortMenuCommands ();
@@ -443,6 +478,7 @@ void praat_addFixedButtonCommand_ (GuiForm parent, conststring32 title, UiCallba
 	}
 	my executable = false;
 	theCommands. addItemAtPosition_move (me.move(), 0);
+	invalidateCommandsByTitle ();
 }
 
 void praat_sensitivizeFixedButtonCommand (conststring32 title, bool sensitive) {
@@ -462,16 +498,7 @@ void praat_sensitivizeFixedButtonCommand (conststring32 title, bool sensitive) {
 }
 
 int praat_doMenuCommand (conststring32 title, conststring32 arguments, Interpreter interpreter) {
-	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
-		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title.get(), title) &&
-			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")))
-		{
-			commandFound = command;
-			break;
-		}
-	}
+	Praat_Command commandFound = lookUpExecutableObjectsOrPictureCommand (title);
 	if (! commandFound)
 		return 0;
 	if (commandFound -> callback == DO_RunTheScriptFromAnyAddedMenuCommand) {
@@ -494,16 +521,7 @@ int praat_doMenuCommand (conststring32 title, conststring32 arguments, Interpret
 }
 
 int praat_doMenuCommand (conststring32 title, integer narg, Stackel args, Interpreter interpreter) {
-	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
-		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title.get(), title) &&
-			(str32equ (command -> window.get(), U"Objects") || str32equ (command -> window.get(), U"Picture")))
-		{
-			commandFound = command;
-			break;
-		}
-	}
+	Praat_Command commandFound = lookUpExecutableObjectsOrPictureCommand (title);
 	if (! commandFound)
 		return 0;
 	if (commandFound -> callback == DO_RunTheScriptFromAnyAddedMenuCommand) {
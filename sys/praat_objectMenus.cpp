@@ -26,6 +26,7 @@
 #include "site.h"
 #include "GraphicsP.h"
 #include "DemoEditor.h"
+#include "MelderThread.h"
 
 #define EDITOR  theCurrentPraatObjects -> list [IOBJECT]. editors
 
@@ -418,6 +419,20 @@ DO
 	PREFS_END
 }
 
+FORM (SETTINGS__debugMultithreading, U"Debug multi-threading", nullptr) {
+	BOOLEAN (useMultithreading, U"Use multi-threading", true)
+	INTEGER (maximumNumberOfThreads, U"Maximum number of threads", U"0")
+	COMMENT (U"0 means: as many threads as there are processors.")
+OK
+	SET_BOOLEAN (useMultithreading, MelderThread_getUseMultithreading ())
+	SET_INTEGER (maximumNumberOfThreads, MelderThread_getMaximumNumberOfThreadsSetting ())
+DO
+	PREFS
+		MelderThread_setUseMultithreading (useMultithreading);
+		MelderThread_setMaximumNumberOfThreads (maximumNumberOfThreads);
+	PREFS_END
+}
+
 DIRECT (INFO_NONE__listReadableTypesOfObjects) {
 	INFO_NONE
 		Thing_listReadableClasses ();
@@ -470,6 +485,18 @@ DIRECT (INFO_NONE__reportMemoryUse) {
 	INFO_NONE_END
 }
 
+DIRECT (INFO_NONE__reportFormulaCache) {
+	INFO_NONE
+		praat_reportFormulaCache ();
+	INFO_NONE_END
+}
+
+DIRECT (INFO_NONE__reportStartUpTimes) {
+	INFO_NONE
+		praat_reportStartUpTimes ();
+	INFO_NONE_END
+}
+
 DIRECT (INFO_NONE__reportTextProperties) {
 	INFO_NONE
 		praat_reportTextProperties ();
@@ -857,6 +884,10 @@ void praat_addMenus (GuiWindow window) {
 	technicalMenu = menuItem ? menuItem -> d_menu : nullptr;
 	praat_addMenuCommand (U"Objects", U"Technical", U"Report memory use",
 			nullptr, 0, INFO_NONE__reportMemoryUse);
+	praat_addMenuCommand (U"Objects", U"Technical", U"Report formula cache",
+			nullptr, 0, INFO_NONE__reportFormulaCache);
+	praat_addMenuCommand (U"Objects", U"Technical", U"Report start-up times",
+			nullptr, 0, INFO_NONE__reportStartUpTimes);
 	praat_addMenuCommand (U"Objects", U"Technical", U"Report integer properties",
 			nullptr, 0, INFO_NONE__reportIntegerProperties);
 	praat_addMenuCommand (U"Objects", U"Technical", U"Report system properties",
@@ -869,6 +900,8 @@ void praat_addMenus (GuiWindow window) {
 			nullptr, 0, INFO_NONE__reportFontProperties);
 	praat_addMenuCommand (U"Objects", U"Technical", U"Debug...",
 			nullptr, 0, SETTINGS__debug);
+	praat_addMenuCommand (U"Objects", U"Technical", U"Debug multi-threading...",
+			nullptr, 0, SETTINGS__debugMultithreading);
 	praat_addMenuCommand (U"Objects", U"Technical", U"-- api --", nullptr, 0, nullptr);
 	praat_addMenuCommand (U"Objects", U"Technical", U"List readable types of objects",
 			nullptr, 0, INFO_NONE__listReadableTypesOfObjects);
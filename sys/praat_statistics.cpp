@@ -22,6 +22,9 @@
 #if defined (macintosh)
 	#include <pwd.h>
 #endif
+#if defined (UNIX) || defined (macintosh)
+	#include <sys/resource.h>
+#endif
 #include "praatP.h"
 #include "GraphicsP.h"
 
@@ -271,6 +274,25 @@ void praat_reportFontProperties () {
 	MelderInfo_close ();
 }
 
+/*
+	The largest amount of physical memory that this process has occupied so far,
+	in bytes, or 0 if the system cannot tell us.
+*/
+static int64 peakResidentSetSize () {
+	#if defined (UNIX) || defined (macintosh)
+		struct rusage usage;
+		if (getrusage (RUSAGE_SELF, & usage) != 0)
+			return 0;
+		#if defined (macintosh)
+			return (int64) usage.ru_maxrss;   // in bytes
+		#else
+			return (int64) usage.ru_maxrss * 1024;   // in kilobytes
+		#endif
+	#else
+		return 0;
+	#endif
+}
+
 void praat_reportMemoryUse () {
 	MelderInfo_open ();
 	MelderInfo_writeLine (U"Memory use by Praat:\n");
@@ -302,6 +324,7 @@ void praat_reportMemoryUse () {
 	MelderInfo_writeLine (U"   Total deleted: ", Melder_bigInteger (Melder_deallocationCount ()));
 	MelderInfo_writeLine (U"   Reallocations: ", Melder_bigInteger (Melder_movingReallocationsCount ()), U" moving, ",
 		Melder_bigInteger (Melder_reallocationsInSituCount ()), U" in situ");
+	MelderInfo_writeLine (U"   Peak resident set size: ", peakResidentSetSize (), U" bytes");
 	MelderInfo_writeLine (
 			U"   Strings created: ", Melder_bigInteger (MelderString_allocationCount ()),
 			U" (", Melder_bigInteger (MelderString_allocationSize ()), U" characters)");
@@ -323,6 +346,78 @@ void praat_reportMemoryUse () {
 	MelderInfo_close ();
 }
 
+/*@praat
+	report$ = Report formula cache
+	numberOfHits = extractNumber (report$, "Found in cache: ")
+	sum = 0
+	for i to 1000
+		sum += i * 2
+	endfor
+	assert sum = 1001000
+	report$ = Report formula cache
+	assert extractNumber (report$, "Found in cache: ") - numberOfHits >= 1000
+	#
+	# The same expression text refers to different local variables in different procedures.
+	#
+	procedure formulaCacheA
+		.x = 1
+		.y = .x + 1
+	endproc
+	procedure formulaCacheB
+		.x = 10
+		.y = .x + 1
+	endproc
+	@formulaCacheA
+	@formulaCacheB
+	assert formulaCacheA.y = 2 and formulaCacheB.y = 11
+	#
+	# An expression with an object name has to be compiled again every time.
+	#
+	for i to 3
+		sound = Create Sound from formula: "formulaCache", 1, 0, 0.01, 1000, string$ (i)
+		assert Sound_formulaCache [1] = i
+		removeObject: sound
+	endfor
+@*/
+void praat_reportFormulaCache () {
+	const Formula_CacheStatistics cacheStatistics = Formula_getCacheStatistics ();
+	const integer numberOfCompilations = cacheStatistics.numberOfHits + cacheStatistics.numberOfMisses + cacheStatistics.numberOfUncacheableExpressions;
+	MelderInfo_open ();
+	MelderInfo_writeLine (U"Script expressions compiled in this session: ", numberOfCompilations);
+	MelderInfo_writeLine (U"   Found in cache: ", cacheStatistics.numberOfHits,
+		U" (", Melder_percent (numberOfCompilations > 0 ? double (cacheStatistics.numberOfHits) / numberOfCompilations : 0.0, 1), U")");
+	MelderInfo_writeLine (U"   Compiled and cached: ", cacheStatistics.numberOfMisses);
+	MelderInfo_writeLine (U"   Compiled but not cached: ", cacheStatistics.numberOfUncacheableExpressions);
+	MelderInfo_writeLine (U"Expressions currently in cache: ", cacheStatistics.numberOfCachedExpressions);
+	MelderInfo_close ();
+}
+
+/*@praat
+	report$ = Report start-up times
+	init = extractNumber (report$, "Initializing Praat: ")
+	libraries = extractNumber (report$, "Installing the commands of the libraries: ")
+	manPages = extractNumber (report$, "Registering the manual pages: ")
+	run = extractNumber (report$, "Reading preferences, start-up files and plug-ins: ")
+	total = extractNumber (report$, "Total: ")
+	assert init > 0 and libraries > 0 and manPages >= 0 and run >= 0
+	assert abs (total - (init + libraries + manPages + run)) < 1e-5
+@*/
+void praat_reportStartUpTimes () {
+	const ManPages manPages = theCurrentPraatApplication -> manPages;
+	MelderInfo_open ();
+	MelderInfo_writeLine (U"Start-up times of this session of Praat:\n");
+	MelderInfo_writeLine (U"Initializing Praat: ", Melder_fixed (praatP.startUpTimes.init, 6), U" seconds");
+	MelderInfo_writeLine (U"Installing the commands of the libraries: ", Melder_fixed (praatP.startUpTimes.libraries, 6), U" seconds");
+	MelderInfo_writeLine (U"Registering the manual pages: ", Melder_fixed (praatP.startUpTimes.manPages, 6), U" seconds");
+	MelderInfo_writeLine (U"Reading preferences, start-up files and plug-ins: ", Melder_fixed (praatP.startUpTimes.run, 6), U" seconds");
+	MelderInfo_writeLine (U"Total: ", Melder_fixed (praatP.startUpTimes.init + praatP.startUpTimes.libraries +
+			praatP.startUpTimes.manPages + praatP.startUpTimes.run, 6), U" seconds");
+	MelderInfo_writeLine (U"\nManual pages parsed so far: ", manPages -> pages.size);
+	MelderInfo_writeLine (U"Notebook texts of the manual not yet parsed: ", manPages -> unparsedNotebookTexts.size,
+			U" (they will be parsed when the manual is first consulted)");
+	MelderInfo_close ();
+}
+
 void MelderCasual_memoryUse (integer message) {
 	integer numberOfStrings = MelderString_allocationCount () - MelderString_deallocationCount ();
 	integer numberOfArrays = MelderArray_allocationCount () - MelderArray_deallocationCount ();